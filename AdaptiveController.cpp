@@ -0,0 +1,107 @@
+/*
+* AdaptiveController.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class steers a SudokuPopulation while it runs. After every
+* generation it looks at the best and mean fitness:
+*    - when the best fitness improves, the mutation rate is lowered one
+*      step back towards its starting value, since the search is working
+*    - when neither the best nor the mean fitness has improved for a while,
+*      the mutation rate is raised one step to search further away
+*    - when the best fitness has not improved for restartAfter generations,
+*      the population is partly restarted (the elites are kept and the
+*      rest are refilled) and the mutation rate goes back to its start
+* Every decision only depends on the scores, so runs stay reproducible.
+*/
+
+#include "AdaptiveController.h"
+#include <algorithm>
+
+/*
+* This constructor remembers the population's current mutation rate as
+* the starting rate. The rate is kept between options.minPercent and
+* options.maxPercent, widened to take in the starting rate, so a start
+* outside the usual range is not clamped on the first update.
+*/
+AdaptiveController::AdaptiveController(SudokuPopulation& population,
+   const AdaptiveOptions& options) : population_(population),
+   options_(options), sinceBest_(0), sinceProgress_(0) {
+   startPercent_ = population.getMutationPercent();
+   options_.minPercent = min(options_.minPercent, startPercent_);
+   options_.maxPercent = max(options_.maxPercent, startPercent_);
+   bestSeen_ = population.bestFitness();
+   meanSeen_ = population.meanFitness();
+}
+
+/*
+* This method is called after every generation. It updates the
+* population's mutation rate and restarts it if it has stagnated.
+*/
+void AdaptiveController::update() {
+   int best = population_.bestFitness();
+   double mean = population_.meanFitness();
+   int percent = population_.getMutationPercent();
+
+   if (best < bestSeen_) {
+      // Progress, so step back towards the starting rate
+      bestSeen_ = best;
+      sinceBest_ = 0;
+      sinceProgress_ = 0;
+      if (percent > startPercent_) {
+         percent--;
+      } else if (percent < startPercent_) {
+         percent++;
+      }
+   } else {
+      sinceBest_++;
+
+      // The mean still falling counts as progress too
+      if (mean < meanSeen_) {
+         sinceProgress_ = 0;
+      } else {
+         sinceProgress_++;
+      }
+
+      // Stuck for a while, so mutate more
+      if (sinceProgress_ > 0 && sinceProgress_ % options_.raiseEvery == 0) {
+         percent++;
+      }
+   }
+   meanSeen_ = min(meanSeen_, mean);
+
+   // Stuck for a long time, so keep the elites and start the rest over
+   if (options_.restartAfter > 0 && sinceBest_ >= options_.restartAfter) {
+      population_.restart(options_.restartKeep);
+      sinceBest_ = 0;
+      sinceProgress_ = 0;
+      percent = startPercent_;
+      meanSeen_ = population_.meanFitness();
+   }
+
+   population_.setMutationPercent(max(options_.minPercent,
+      min(options_.maxPercent, percent)));
+}
+
+/*
+* These methods return and restore the controller's state (see
+* Checkpoint.h).
+*/
+AdaptiveState AdaptiveController::getState() const {
+   AdaptiveState state;
+   state.startPercent = startPercent_;
+   state.bestSeen = bestSeen_;
+   state.meanSeen = meanSeen_;
+   state.sinceBest = sinceBest_;
+   state.sinceProgress = sinceProgress_;
+   return state;
+}
+
+void AdaptiveController::setState(const AdaptiveState& state) {
+   startPercent_ = state.startPercent;
+   options_.minPercent = min(options_.minPercent, startPercent_);
+   options_.maxPercent = max(options_.maxPercent, startPercent_);
+   bestSeen_ = state.bestSeen;
+   meanSeen_ = state.meanSeen;
+   sinceBest_ = state.sinceBest;
+   sinceProgress_ = state.sinceProgress;
+}
@@ -0,0 +1,100 @@
+/*
+* AdaptiveController.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class steers a SudokuPopulation while it runs. After every
+* generation it looks at the best and mean fitness:
+*    - when the best fitness improves, the mutation rate is lowered one
+*      step back towards its starting value, since the search is working
+*    - when neither the best nor the mean fitness has improved for a while,
+*      the mutation rate is raised one step to search further away
+*    - when the best fitness has not improved for restartAfter generations,
+*      the population is partly restarted (the elites are kept and the
+*      rest are refilled) and the mutation rate goes back to its start
+* Every decision only depends on the scores, so runs stay reproducible.
+*/
+
+#pragma once
+#include "SudokuPopulation.h"
+
+/*
+* This struct holds the settings of the controller.
+*/
+struct AdaptiveOptions {
+   int minPercent = 0;           // lowest mutation rate
+   int maxPercent = 20;          // highest mutation rate (raised to the
+                                 // starting rate if that is higher)
+   int raiseEvery = 10;          // stagnant generations between raises
+   int restartAfter = 200;       // stagnant generations before a restart
+   double restartKeep = 0.1;     // fraction kept by a restart (elites)
+};
+
+/*
+* This struct holds everything the controller has learned during a run, so
+* that it can be saved in a checkpoint and restored.
+*/
+struct AdaptiveState {
+   int startPercent = 0;          // mutation rate the run started with
+   int bestSeen = 0;              // best fitness seen so far
+   double meanSeen = 0;           // lowest mean fitness seen so far
+   int sinceBest = 0;             // generations since the best improved
+   int sinceProgress = 0;         // generations since best or mean improved
+};
+
+class AdaptiveController
+{
+public:
+   /*
+   * This constructor remembers the population's current mutation rate as
+   * the starting rate. The rate is kept between options.minPercent and
+   * options.maxPercent, widened to take in the starting rate, so a start
+   * outside the usual range is not clamped on the first update.
+   */
+   AdaptiveController(SudokuPopulation& population,
+      const AdaptiveOptions& options);
+
+   /*
+   * This method is called after every generation. It updates the
+   * population's mutation rate and restarts it if it has stagnated.
+   */
+   void update();
+
+   /*
+   * These methods return and restore the controller's state (see
+   * Checkpoint.h).
+   */
+   AdaptiveState getState() const;
+   void setState(const AdaptiveState& state);
+
+private:
+   /*
+   * This field is the population being steered.
+   */
+   SudokuPopulation& population_;
+
+   /*
+   * This field holds the settings.
+   */
+   AdaptiveOptions options_;
+
+   /*
+   * This field is the mutation rate the population started with.
+   */
+   int startPercent_;
+
+   /*
+   * These fields are the best and mean fitness seen so far.
+   */
+   int bestSeen_;
+   double meanSeen_;
+
+   /*
+   * This field counts generations since the best fitness improved.
+   */
+   int sinceBest_;
+
+   /*
+   * This field counts generations since the best or mean improved.
+   */
+   int sinceProgress_;
+};
@@ -0,0 +1,80 @@
+/*
+* AllocationCounter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions count heap allocations made by the program. The .cpp file
+* replaces the global operator new and operator delete with versions that
+* bump an atomic counter before calling malloc/free, so the counter sees
+* every new in the program, including the ones inside the standard library.
+* It is used to check that the steady-state generation loop does not
+* allocate.
+*/
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*
+* This variable holds the number of allocations made so far.
+*/
+static std::atomic<long long> allocations(0);
+
+/*
+* This function returns the number of times operator new has been called
+* since the program started.
+*/
+long long allocationCount() {
+   return allocations.load(std::memory_order_relaxed);
+}
+
+/*
+* This replacement for the global operator new counts the allocation and
+* then gets the memory from malloc.
+*/
+void* operator new(std::size_t size) {
+   allocations.fetch_add(1, std::memory_order_relaxed);
+
+   // malloc(0) may return nullptr, but new must return a unique pointer
+   void* memory = std::malloc(size == 0 ? 1 : size);
+   if (memory == nullptr) {
+      throw std::bad_alloc();
+   }
+
+   return memory;
+}
+
+/*
+* This replacement for the global operator new[] forwards to operator new.
+*/
+void* operator new[](std::size_t size) {
+   return operator new(size);
+}
+
+/*
+* This replacement for the global operator delete frees memory that came
+* from the operator new above.
+*/
+void operator delete(void* memory) noexcept {
+   std::free(memory);
+}
+
+/*
+* This replacement for the global operator delete[] forwards to operator
+* delete.
+*/
+void operator delete[](void* memory) noexcept {
+   operator delete(memory);
+}
+
+/*
+* These sized versions of delete are used by C++14 compilers. They ignore
+* the size and forward to the unsized versions.
+*/
+void operator delete(void* memory, std::size_t) noexcept {
+   operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+   operator delete(memory);
+}
@@ -0,0 +1,19 @@
+/*
+* AllocationCounter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions count heap allocations made by the program. The .cpp file
+* replaces the global operator new and operator delete with versions that
+* bump an atomic counter before calling malloc/free, so the counter sees
+* every new in the program, including the ones inside the standard library.
+* It is used to check that the steady-state generation loop does not
+* allocate.
+*/
+
+#pragma once
+
+/*
+* This function returns the number of times operator new has been called
+* since the program started.
+*/
+long long allocationCount();
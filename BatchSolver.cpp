@@ -0,0 +1,177 @@
+/*
+* BatchSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions solve a whole corpus of puzzles in one run. They read one
+* 81-character puzzle per line (from a stream or a PuzzleCorpus), solve
+* several puzzles at the same time on a thread pool and write one compact
+* line per puzzle:
+*
+*    <line> <solution> <fitness> <generations> <milliseconds>
+*
+* Lines are written as puzzles finish, so they may be out of order (the
+* line number says which puzzle it was). Each job reads the next puzzle as
+* soon as it has finished one, so corpora larger than memory work and a
+* slow puzzle only holds up its own job. When every puzzle is done a
+* summary with the throughput and latency percentiles is printed to cerr.
+*/
+
+#include "BatchSolver.h"
+#include "BufferedWriter.h"
+#include "PuzzleCorpus.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+* This helper returns the value at fraction (0-1) of the way through a
+* sorted list, or 0 if the list is empty.
+*/
+static double percentile(const vector<double>& sorted, double fraction) {
+   if (sorted.empty()) {
+      return 0;
+   }
+   return sorted[(size_t)(fraction * (sorted.size() - 1) + 0.5)];
+}
+
+/*
+* This helper solves every puzzle that read hands out. read(sudoku, line)
+* fills in the next puzzle and its line number and returns false at the end
+* of the input. Every job takes turns with the others to read one puzzle,
+* solves it and then reads the next, so no job waits for another to finish
+* and the whole corpus never has to be held in memory.
+*/
+template <typename Reader>
+static void solveAll(Reader& read, FILE* out, const SolverOptions& options,
+   int jobs) {
+   BufferedWriter writer(out);
+   ThreadPool pool(jobs);
+
+   // The reader and the results are shared between the jobs
+   mutex inputLock;
+   mutex outputLock;
+   vector<double> latencies;
+   long long solved = 0;
+
+   // Each task is one job, solving puzzles until the input runs out
+   auto solveUntilDone = [&](int) {
+      Sudoku puzzle;
+      long long lineNumber;
+
+      // Invariant: every puzzle this job has read has been written out
+      while (true) {
+         {
+            lock_guard<mutex> lock(inputLock);
+            if (!read(puzzle, lineNumber)) {
+               return;
+            }
+         }
+
+         SolverOptions puzzleOptions = options;
+         puzzleOptions.seed = Random::stream(options.seed, lineNumber).next();
+
+         auto puzzleStart = chrono::steady_clock::now();
+         SolveResult result = solve(puzzle, puzzleOptions);
+         chrono::duration<double, milli> elapsed =
+            chrono::steady_clock::now() - puzzleStart;
+
+         // Format the line before taking the lock
+         char cells[81];
+         result.best.writeCells(cells);
+
+         lock_guard<mutex> lock(outputLock);
+         writer.writeInt(lineNumber);
+         writer.write(' ');
+         writer.write(cells, 81);
+         writer.write(' ');
+         writer.writeInt(result.fitness);
+         writer.write(' ');
+         writer.writeInt(result.generations);
+         writer.write(' ');
+         writer.writeDouble(elapsed.count(), 3);
+         writer.write('\n');
+
+         latencies.push_back(elapsed.count());
+         if (result.fitness == 0) {
+            solved++;
+         }
+      }
+   };
+
+   auto start = chrono::steady_clock::now();
+   pool.parallelFor(jobs, solveUntilDone);
+   writer.flush();
+
+   chrono::duration<double> total = chrono::steady_clock::now() - start;
+
+   // Summary goes to cerr so the results stay machine readable
+   sort(latencies.begin(), latencies.end());
+   double seconds = total.count();
+   cerr << "Solved " << solved << " of " << latencies.size()
+      << " puzzles in " << seconds << " s ("
+      << (seconds > 0 ? latencies.size() / seconds : 0)
+      << " puzzles/sec), latency p50 " << percentile(latencies, 0.50)
+      << " ms, p99 " << percentile(latencies, 0.99) << " ms" << endl;
+}
+
+/*
+* This function solves every puzzle read from in using options and writes
+* the results to out. jobs is the number of puzzles solved at the same
+* time. Lines use the PuzzleCorpus format ('.' or 0 for a blank); any
+* other line is reported to cerr and skipped. Each puzzle gets its own
+* seed derived from options.seed and its line number, so a batch is
+* reproducible. Returns 0 on success or -1 if any line could not be read
+* as a puzzle.
+*/
+int runBatch(istream& in, FILE* out, const SolverOptions& options, int jobs) {
+   int status = 0;
+   long long lineNumber = 0;
+   string line;
+
+   // Read one puzzle per line in the PuzzleCorpus format, skipping blank
+   // and comment lines
+   auto read = [&](Sudoku& sudoku, long long& puzzleLine) {
+      while (getline(in, line)) {
+         lineNumber++;
+         size_t first = line.find_first_not_of(" \t\r");
+         if (first == string::npos || line[first] == '#') {
+            continue;
+         }
+
+         const char* begin = line.data() + first;
+         long long bad = PuzzleCorpus::parseLine(begin,
+            line.data() + line.size(), sudoku);
+         if (bad >= 0) {
+            cerr << "ERROR: Malformed puzzle on line " << lineNumber
+               << " (column " << first + bad + 1 << ")" << endl;
+            status = -1;
+            continue;
+         }
+
+         puzzleLine = lineNumber;
+         return true;
+      }
+      return false;
+   };
+
+   solveAll(read, out, options, jobs);
+   return status;
+}
+
+/*
+* This function does the same as the istream version but reads the puzzles
+* from a memory-mapped corpus, which is much faster for large files.
+*/
+int runBatch(PuzzleCorpus& corpus, FILE* out, const SolverOptions& options,
+   int jobs) {
+   auto read = [&](Sudoku& sudoku, long long& puzzleLine) {
+      return corpus.next(sudoku, puzzleLine);
+   };
+
+   solveAll(read, out, options, jobs);
+   return corpus.getMalformed() > 0 ? -1 : 0;
+}
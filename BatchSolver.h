@@ -0,0 +1,41 @@
+/*
+* BatchSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions solve a whole corpus of puzzles in one run. They read one
+* 81-character puzzle per line (from a stream or a PuzzleCorpus), solve
+* several puzzles at the same time on a thread pool and write one compact
+* line per puzzle:
+*
+*    <line> <solution> <fitness> <generations> <milliseconds>
+*
+* Lines are written as puzzles finish, so they may be out of order (the
+* line number says which puzzle it was). Each job reads the next puzzle as
+* soon as it has finished one, so corpora larger than memory work and a
+* slow puzzle only holds up its own job. When every puzzle is done a
+* summary with the throughput and latency percentiles is printed to cerr.
+*/
+
+#pragma once
+#include <cstdio>
+#include <iostream>
+#include "PuzzleCorpus.h"
+#include "Solver.h"
+
+/*
+* This function solves every puzzle read from in using options and writes
+* the results to out. jobs is the number of puzzles solved at the same
+* time. Lines use the PuzzleCorpus format ('.' or 0 for a blank); any
+* other line is reported to cerr and skipped. Each puzzle gets its own
+* seed derived from options.seed and its line number, so a batch is
+* reproducible. Returns 0 on success or -1 if any line could not be read
+* as a puzzle.
+*/
+int runBatch(istream& in, FILE* out, const SolverOptions& options, int jobs);
+
+/*
+* This function does the same as the istream version but reads the puzzles
+* from a memory-mapped corpus, which is much faster for large files.
+*/
+int runBatch(PuzzleCorpus& corpus, FILE* out, const SolverOptions& options,
+   int jobs);
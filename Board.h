@@ -0,0 +1,348 @@
+/*
+* Board.h
+* Timothy Kozlov, Eric Pham
+*
+* This class template implements the Puzzle interface for a sudoku board of
+* any size. BOX is the width of a box, so the board has SIZE = BOX * BOX
+* rows and columns and uses the digits 1 to SIZE (0 is an empty cell). Like
+* Sudoku, it keeps per-unit digit counts so that setDigitAt can track the
+* change in fitness score and a Zobrist hash (see BoardTables.h).
+*
+* Sudoku is still the board used for 9x9 puzzles; Board<3> only exists so
+* a 9x9 puzzle can be read in the same formats as the larger boards and
+* then handed to Sudoku (see BoardSolver.h).
+*
+* Cells are written as one character each, using the symbols 1-9 and then
+* A-Z for 10-35 (so a 16x16 board uses 1-9 and A-G), with 0 or . for an
+* empty cell. Boards can also be read as whitespace-separated numbers
+* (0 for empty), see readPuzzle.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include "Puzzle.h"
+#include "BoardTables.h"
+
+template <int BOX>
+class Board : public Puzzle
+{
+public:
+   static constexpr int SIZE = BoardTables<BOX>::SIZE;
+   static constexpr int CELLS = BoardTables<BOX>::CELLS;
+   static constexpr int UNITS = BoardTables<BOX>::UNITS;
+
+   // Decimal digits in SIZE, the longest token read as one number
+   static constexpr int NUMBER_WIDTH = SIZE < 10 ? 1 : 2;
+
+   /*
+   * This is the default constructor. It represents a completely empty
+   * board where no cell is fixed.
+   */
+   Board() : data_{ 0 }, fixed_{ false }, fitnessDelta_(0), hash_(0) {
+      countUnits();
+   }
+
+   /*
+   * This copy constructor and assignment operator copy the cells, fixed
+   * flags, unit counts and hash from other. Like Sudoku, the copy starts
+   * with a fitness delta of zero.
+   */
+   Board(const Board& other) : Puzzle() {
+      *this = other;
+   }
+
+   Board& operator=(const Board& other) {
+      copy(other.data_, other.data_ + CELLS, data_);
+      copy(other.fixed_, other.fixed_ + CELLS, fixed_);
+      copy(&other.unitFreq_[0][0], &other.unitFreq_[0][0]
+         + UNITS * (SIZE + 1), &unitFreq_[0][0]);
+      fitnessDelta_ = 0;
+      hash_ = other.hash_;
+      return *this;
+   }
+
+   /*
+   * This method is an implementation from the Puzzle interface. It reads
+   * CELLS cells in row-major order and fixes every cell that is not empty.
+   * Input is split into whitespace-separated tokens. A token of decimal
+   * digits no longer than SIZE written in decimal (one digit for 9x9, two
+   * for bigger boards) is the number of one cell (so "12" is the digit 12
+   * on a 16x16 board, but two cells on a 9x9 one). Any longer token, or
+   * one containing a letter or '.', holds one cell per character. Both
+   * formats can be mixed. Throws a runtime_error if the input ends early
+   * or a digit is larger than SIZE.
+   */
+   istream& readPuzzle(istream& is) {
+      int cell = 0;
+      string token;
+
+      // Invariant: cells 0 to cell - 1 have been read
+      while (cell < CELLS && is >> token) {
+         bool number = (int) token.size() <= NUMBER_WIDTH
+            && isdigit((unsigned char) token[0])
+            && isdigit((unsigned char) token.back());
+         if (number) {
+            int digit = stoi(token);
+            if (digit > SIZE) {
+               throw runtime_error("Board digit " + token
+                  + " is larger than " + to_string(SIZE));
+            }
+            data_[cell] = (unsigned char) digit;
+            cell++;
+            continue;
+         }
+
+         // One cell per character
+         for (size_t i = 0; i < token.size() && cell < CELLS; i++) {
+            data_[cell] = checkDigit(digitOf(token[i]));
+            cell++;
+         }
+      }
+      if (cell < CELLS) {
+         throw runtime_error("Invalid board input passed via istream");
+      }
+
+      // Anything but zero will be fixed
+      for (int i = 0; i < CELLS; i++) {
+         fixed_[i] = data_[i] != 0;
+      }
+
+      // data_ was written directly, so rebuild the unit counts
+      countUnits();
+      fitnessDelta_ = 0;
+      return is;
+   }
+
+   /*
+   * This method is an implementation from the Puzzle interface. It prints
+   * the board with lines between the boxes, like Sudoku#writePuzzle, using
+   * one symbol per cell.
+   */
+   ostream& writePuzzle(ostream& os) const {
+      // Style line: a "+" after each box width of dashes
+      string line = "+";
+      for (int box = 0; box < BOX; box++) {
+         line += string(2 * BOX + 1, '-') + "+";
+      }
+
+      // Loop invariant: 0 <= row < SIZE
+      for (int row = 0; row < SIZE; row++) {
+         // Every BOX rows, print a horizontal line
+         if (row % BOX == 0) {
+            os << line << endl;
+         }
+         // Loop invariant: 0 <= col < SIZE
+         for (int col = 0; col < SIZE; col++) {
+            // Every BOX columns, print a vertical line
+            if (col % BOX == 0) {
+               os << "| ";
+            }
+            os << symbolOf(data_[row * SIZE + col]) << " ";
+         }
+         // Print vertical line to close right side
+         os << "|" << endl;
+      }
+
+      // Print horizontal line to close bottom
+      os << line;
+      return os;
+   }
+
+   /*
+   * This method writes the CELLS symbols of the board in row-major order
+   * into out (no terminating null), the compact one-line format.
+   */
+   void writeCells(char* out) const {
+      for (int cell = 0; cell < CELLS; cell++) {
+         out[cell] = symbolOf(data_[cell]);
+      }
+   }
+
+   /*
+   * This method returns the digit stored at row and col.
+   */
+   int getDigitAt(int row, int col) const {
+      // Check bounds
+      if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+         throw runtime_error("Invalid bounds for getDigitAt");
+      }
+      return data_[row * SIZE + col];
+   }
+
+   /*
+   * This method sets the digit at row and col as long as the cell is not
+   * fixed, updating the unit counts, fitness delta and hash like
+   * Sudoku#setDigitAt. Returns false if the cell is fixed.
+   */
+   bool setDigitAt(int row, int col, int digit) {
+      // Check bounds
+      if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+         throw runtime_error("Invalid bounds for setDigitAt");
+      }
+      // Check that digit is legal
+      if (digit <= 0 || digit > SIZE) {
+         throw runtime_error("Invalid domain for board digit in setDigitAt");
+      }
+      return setCell(row * SIZE + col, digit);
+   }
+
+   /*
+   * This method does the same as setDigitAt without the bounds checks. It
+   * is used by the kernels that already walk valid cells.
+   */
+   bool setCell(int cell, int digit) {
+      if (fixed_[cell]) {
+         return false;
+      }
+
+      int old = data_[cell];
+      if (old != digit) {
+         const unsigned char* units = BOARD_TABLES<BOX>.cellUnits[cell];
+         // Invariant: 0 <= i < 3
+         for (int i = 0; i < 3; i++) {
+            unsigned char* freq = unitFreq_[units[i]];
+            // Removing a repeated digit removes one issue
+            if (freq[old] > 1) {
+               fitnessDelta_--;
+            }
+            freq[old]--;
+            // Adding a digit that is already in the unit adds one issue
+            if (freq[digit] > 0) {
+               fitnessDelta_++;
+            }
+            freq[digit]++;
+         }
+         hash_ ^= BOARD_TABLES<BOX>.zobrist[cell][old];
+         hash_ ^= BOARD_TABLES<BOX>.zobrist[cell][digit];
+      }
+
+      data_[cell] = (unsigned char) digit;
+      return true;
+   }
+
+   /*
+   * This method returns a pointer to the CELLS digits in row-major order.
+   */
+   const unsigned char* getCells() const {
+      return data_;
+   }
+
+   /*
+   * This method fills the board from CELLS digits in row-major order,
+   * fixing every digit but zero, like Sudoku#loadCells.
+   */
+   void loadCells(const unsigned char* cells) {
+      for (int cell = 0; cell < CELLS; cell++) {
+         data_[cell] = checkDigit(cells[cell]);
+         fixed_[cell] = cells[cell] != 0;
+      }
+      countUnits();
+      fitnessDelta_ = 0;
+   }
+
+   /*
+   * This method returns true if the cell at row and col came from the
+   * original puzzle and cannot be changed.
+   */
+   bool isFixed(int row, int col) const {
+      return fixed_[row * SIZE + col];
+   }
+
+   /*
+   * These methods return and reset the change in fitness score since the
+   * board was copied, like Sudoku#getFitnessDelta.
+   */
+   int getFitnessDelta() const {
+      return fitnessDelta_;
+   }
+
+   void clearFitnessDelta() {
+      fitnessDelta_ = 0;
+   }
+
+   /*
+   * This method returns the Zobrist hash of the digits on the board.
+   */
+   unsigned long long getHash() const {
+      return hash_;
+   }
+
+   /*
+   * These helpers convert between a digit 0-35 and its symbol.
+   */
+   static char symbolOf(int digit) {
+      return digit < 10 ? (char) ('0' + digit) : (char) ('A' + digit - 10);
+   }
+
+   static int digitOf(char c) {
+      if (c == '.') {
+         return 0;
+      }
+      if (isdigit((unsigned char) c)) {
+         return c - '0';
+      }
+      if (isalpha((unsigned char) c)) {
+         return toupper((unsigned char) c) - 'A' + 10;
+      }
+      throw runtime_error(string("Invalid board symbol ") + c);
+   }
+
+private:
+   /*
+   * This helper throws a runtime_error if digit is not 0 to SIZE.
+   */
+   static unsigned char checkDigit(int digit) {
+      if (digit < 0 || digit > SIZE) {
+         throw runtime_error("Invalid domain for board digit");
+      }
+      return (unsigned char) digit;
+   }
+
+   /*
+   * This helper recounts unitFreq_ and hash_ from scratch using data_.
+   */
+   void countUnits() {
+      for (int unit = 0; unit < UNITS; unit++) {
+         for (int digit = 0; digit <= SIZE; digit++) {
+            unitFreq_[unit][digit] = 0;
+         }
+      }
+
+      hash_ = 0;
+      for (int cell = 0; cell < CELLS; cell++) {
+         for (int i = 0; i < 3; i++) {
+            unitFreq_[BOARD_TABLES<BOX>.cellUnits[cell][i]][data_[cell]]++;
+         }
+         hash_ ^= BOARD_TABLES<BOX>.zobrist[cell][data_[cell]];
+      }
+   }
+
+   /*
+   * The digits of the board in row-major order.
+   */
+   unsigned char data_[CELLS];
+
+   /*
+   * True for each cell that came from the original puzzle.
+   */
+   bool fixed_[CELLS];
+
+   /*
+   * How many times each digit 0 to SIZE appears in each unit.
+   */
+   unsigned char unitFreq_[UNITS][SIZE + 1];
+
+   /*
+   * The change in fitness score since the board was copied or the delta
+   * was last cleared.
+   */
+   int fitnessDelta_;
+
+   /*
+   * The Zobrist hash of data_.
+   */
+   unsigned long long hash_;
+};
@@ -0,0 +1,59 @@
+/*
+* BoardFactory.h
+* Timothy Kozlov, Eric Pham
+*
+* This class template implements the PuzzleFactory interface for
+* Board<BOX>. It follows the singleton pattern and fills or mutates boards
+* the same way SudokuFactory does for 9x9 sudokus.
+*/
+
+#pragma once
+#include "PuzzleFactory.h"
+#include "BoardOffspring.h"
+#include "Board.h"
+
+template <int BOX>
+class BoardFactory : public PuzzleFactory
+{
+public:
+   /*
+   * This singleton method returns the instance for this board size.
+   */
+   static BoardFactory& getInstance() {
+      static BoardFactory instance;
+      return instance;
+   }
+
+   /*
+   * This method is implemented from the PuzzleFactory interface. It clones
+   * unsolved and fills the clone with fillPuzzleInto.
+   */
+   Puzzle* fillPuzzle(const Puzzle& unsolved, Random& rng) const {
+      Board<BOX>* board = new Board<BOX>();
+      fillPuzzleInto(*(const Board<BOX>*) &unsolved, *board, rng);
+      return board;
+   }
+
+   /*
+   * This method is implemented from the PuzzleFactory interface. It uses
+   * BoardOffspring#makeOffspring to return a mutated copy of solved.
+   */
+   Puzzle* createPuzzle(const Puzzle& solved, Random& rng) const {
+      return BoardOffspring<BOX>::getInstance().makeOffspring(solved, rng);
+   }
+
+   /*
+   * This method copies unsolved into out and gives every cell that is not
+   * fixed a random digit drawn from rng. out's fitness delta is cleared,
+   * since it is scored from scratch.
+   */
+   void fillPuzzleInto(const Board<BOX>& unsolved, Board<BOX>& out,
+      Random& rng) const {
+      out = unsolved;
+      // Invariant: 0 <= cell < CELLS
+      for (int cell = 0; cell < Board<BOX>::CELLS; cell++) {
+         out.setCell(cell, rng.nextInt(Board<BOX>::SIZE) + 1);
+      }
+      out.clearFitnessDelta();
+   }
+};
@@ -0,0 +1,68 @@
+/*
+* BoardFitness.h
+* Timothy Kozlov, Eric Pham
+*
+* This class template implements the Fitness interface for Board<BOX>. It
+* follows the singleton pattern (one instance per board size) and scores a
+* board the same way SudokuFitness does: every repeated digit (or empty
+* cell) in a row, column or box counts as one issue.
+*/
+
+#pragma once
+#include <bitset>
+#include "Fitness.h"
+#include "Board.h"
+
+template <int BOX>
+class BoardFitness : public Fitness
+{
+public:
+   /*
+   * This singleton method returns the instance for this board size.
+   */
+   static BoardFitness& getInstance() {
+      static BoardFitness instance;
+      return instance;
+   }
+
+   /*
+   * This method is implemented from the Fitness interface and returns
+   * howFitMask.
+   */
+   int howFit(const Puzzle& puzzle) {
+      return howFitMask(puzzle);
+   }
+
+   /*
+   * This method casts puzzle to a Board<BOX> and, for each unit, sets one
+   * bit per distinct digit. Every cell of the unit that did not add a new
+   * bit is a repeat.
+   */
+   int howFitMask(const Puzzle& puzzle) const {
+      const unsigned char* cells = ((const Board<BOX>*) &puzzle)->getCells();
+      int issues = 0;
+
+      // Invariant: 0 <= unit < UNITS
+      for (int unit = 0; unit < Board<BOX>::UNITS; unit++) {
+         const unsigned short* unitCells = BOARD_TABLES<BOX>.unitCells[unit];
+         unsigned int mask = 0;
+         // Invariant: 0 <= i < SIZE
+         for (int i = 0; i < Board<BOX>::SIZE; i++) {
+            mask |= 1U << cells[unitCells[i]];
+         }
+         issues += Board<BOX>::SIZE - (int) bitset<32>(mask).count();
+      }
+
+      return issues;
+   }
+
+   /*
+   * This method returns the score of an offspring from the score of the
+   * parent it was copied from and the fitness delta tracked by
+   * Board#setDigitAt, like SudokuFitness#howFitDelta.
+   */
+   int howFitDelta(const Puzzle& offspring, int parentScore) const {
+      return parentScore
+         + ((const Board<BOX>*) &offspring)->getFitnessDelta();
+   }
+};
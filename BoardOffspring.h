@@ -0,0 +1,99 @@
+/*
+* BoardOffspring.h
+* Timothy Kozlov, Eric Pham
+*
+* This class template implements the Reproduction interface for
+* Board<BOX>. It follows the singleton pattern and mutates or crosses
+* boards the same way SudokuOffspring does for 9x9 sudokus.
+*/
+
+#pragma once
+#include "Reproduction.h"
+#include "SudokuOffspring.h"
+#include "Board.h"
+
+template <int BOX>
+class BoardOffspring : public Reproduction
+{
+public:
+   /*
+   * This singleton method returns the instance for this board size.
+   */
+   static BoardOffspring& getInstance() {
+      static BoardOffspring instance;
+      return instance;
+   }
+
+   /*
+   * This method is implemented from the Reproduction interface. It clones
+   * puzzle and mutates the clone with makeOffspringInto.
+   */
+   Puzzle* makeOffspring(const Puzzle& puzzle, Random& rng) const {
+      Board<BOX>* copy = new Board<BOX>(*(const Board<BOX>*) &puzzle);
+      makeOffspringInto(*copy, *copy, rng);
+      return copy;
+   }
+
+   /*
+   * This method copies parent into child and then gives every cell a
+   * mutationPercent chance (out of 100, as in SudokuOffspring) of getting
+   * a random digit drawn from rng. Fixed cells never change.
+   */
+   void makeOffspringInto(const Board<BOX>& parent, Board<BOX>& child,
+      Random& rng, int mutationPercent = SudokuOffspring::MUTATION_PERCENT)
+      const {
+      // Copy the parent into the child (skipped if they are the same board)
+      if (&parent != &child) {
+         child = parent;
+      }
+
+      // Invariant: 0 <= cell < CELLS
+      for (int cell = 0; cell < Board<BOX>::CELLS; cell++) {
+         if (rng.nextInt(100) < mutationPercent) {
+            child.setCell(cell, rng.nextInt(Board<BOX>::SIZE) + 1);
+         }
+      }
+   }
+
+   /*
+   * This method is implemented from the Reproduction interface. It clones
+   * mother and copies rows, boxes or single cells over from father, each
+   * with a 50% chance, like SudokuOffspring#crossover.
+   */
+   Puzzle* crossover(const Puzzle& mother, const Puzzle& father,
+      Crossover kind, Random& rng) const {
+      const Board<BOX>& boardFather = *(const Board<BOX>*) &father;
+      Board<BOX>* child = new Board<BOX>(*(const Board<BOX>*) &mother);
+      if (kind == NO_CROSSOVER) {
+         return child;
+      }
+
+      // Single cells, or whole rows (units 0 to SIZE - 1) or boxes
+      const unsigned char* cells = boardFather.getCells();
+      if (kind == UNIFORM_CROSSOVER) {
+         // Invariant: 0 <= cell < CELLS
+         for (int cell = 0; cell < Board<BOX>::CELLS; cell++) {
+            if (rng.nextInt(2) == 1 && cells[cell] != 0) {
+               child->setCell(cell, cells[cell]);
+            }
+         }
+         return child;
+      }
+
+      int firstUnit = kind == ROW_CROSSOVER ? 0 : 2 * Board<BOX>::SIZE;
+      // Invariant: 0 <= i < SIZE
+      for (int i = 0; i < Board<BOX>::SIZE; i++) {
+         if (rng.nextInt(2) == 0) {
+            continue;
+         }
+         const unsigned short* unit =
+            BOARD_TABLES<BOX>.unitCells[firstUnit + i];
+         for (int j = 0; j < Board<BOX>::SIZE; j++) {
+            if (cells[unit[j]] != 0) {
+               child->setCell(unit[j], cells[unit[j]]);
+            }
+         }
+      }
+      return child;
+   }
+};
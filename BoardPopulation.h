@@ -0,0 +1,21 @@
+/*
+* BoardPopulation.h
+* Timothy Kozlov, Eric Pham
+*
+* BoardPopulation<BOX> is the population used for Board<BOX>: the
+* GeneticEngine with the Board operators and truncation selection. It is
+* the plain version of SudokuPopulation (mutation only, one thread), and
+* never allocates during a generation.
+*/
+
+#pragma once
+#include "Board.h"
+#include "BoardFactory.h"
+#include "BoardFitness.h"
+#include "BoardOffspring.h"
+#include "GeneticEngine.h"
+#include "TruncationSelection.h"
+
+template <int BOX>
+using BoardPopulation = GeneticEngine<Board<BOX>, BoardFactory<BOX>,
+   BoardFitness<BOX>, BoardOffspring<BOX>, TruncationSelection>;
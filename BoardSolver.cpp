@@ -0,0 +1,88 @@
+/*
+* BoardSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This function template runs the genetic algorithm on a Board<BOX> of any
+* size, using the population size, generation limit, cull percent, seed
+* and mutation rate from SolverOptions. The other settings only apply to
+* 9x9 puzzles, so checkBoardOptions rejects them for bigger boards instead
+* of ignoring them.
+*
+* solveBoard<3> is fully specialized: a 9x9 board is copied into a Sudoku
+* and solved by solve in Solver.h, so 9x9 puzzles keep every feature and
+* the fast fixed-size kernels whichever way they were read.
+*/
+
+#include "BoardSolver.h"
+
+/*
+* This function throws a runtime_error naming the first setting in
+* options that solveBoard cannot use for boards bigger than 9x9 (anything
+* but the population size, generation limit, cull percent, seed, mutation
+* rate and propagation, which bigger boards never do).
+*/
+void checkBoardOptions(const SolverOptions& options) {
+   SolverOptions defaults;
+   string flag;
+
+   if (options.engine != defaults.engine) {
+      flag = "--engine";
+   } else if (options.selection != defaults.selection) {
+      flag = "--selection";
+   } else if (options.encoding != defaults.encoding) {
+      flag = "--encoding";
+   } else if (options.crossover != defaults.crossover) {
+      flag = "--crossover";
+   } else if (options.adaptive) {
+      flag = "--adaptive and --restart-after";
+   } else if (options.arena) {
+      flag = "--arena";
+   } else if (options.cacheEntries != defaults.cacheEntries) {
+      flag = "--cache";
+   } else if (options.rejectDuplicates) {
+      flag = "--no-duplicates";
+   } else if (options.threads != defaults.threads
+      || options.chunkSize != defaults.chunkSize) {
+      flag = "--threads and --chunk";
+   } else if (options.islands != defaults.islands
+      || options.migrationInterval != defaults.migrationInterval
+      || options.migrants != defaults.migrants) {
+      flag = "--islands, --migrate-every and --migrants";
+   } else if (!options.checkpointFile.empty()
+      || !options.resumeFile.empty()) {
+      flag = "--checkpoint and --resume";
+   } else if (options.timeLimitMs > 0 || options.cancel != nullptr) {
+      flag = "--time-limit";
+   } else if (options.telemetry != nullptr) {
+      flag = "--telemetry";
+   }
+
+   if (!flag.empty()) {
+      throw runtime_error(flag + " can only be used with 9x9 puzzles");
+   }
+}
+
+/*
+* This specialization copies the 9x9 board into a Sudoku, solves it with
+* solve and copies the best Sudoku back into a board.
+*/
+template <>
+BoardResult<3> solveBoard<3>(const Board<3>& puzzle,
+   const SolverOptions& options) {
+   Sudoku sudoku;
+   sudoku.loadCells(puzzle.getCells());
+   SolveResult solved = solve(sudoku, options);
+
+   // Fixed cells are the same in both, so only the others are copied
+   BoardResult<3> result;
+   result.best = puzzle;
+   const int* cells = solved.best.getCells();
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      result.best.setCell(cell, cells[cell]);
+   }
+   result.best.clearFitnessDelta();
+   result.fitness = solved.fitness;
+   result.generations = solved.generations;
+   return result;
+}
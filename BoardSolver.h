@@ -0,0 +1,68 @@
+/*
+* BoardSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This function template runs the genetic algorithm on a Board<BOX> of any
+* size, using the population size, generation limit, cull percent, seed
+* and mutation rate from SolverOptions. The other settings only apply to
+* 9x9 puzzles, so checkBoardOptions rejects them for bigger boards instead
+* of ignoring them.
+*
+* solveBoard<3> is fully specialized: a 9x9 board is copied into a Sudoku
+* and solved by solve in Solver.h, so 9x9 puzzles keep every feature and
+* the fast fixed-size kernels whichever way they were read.
+*/
+
+#pragma once
+#include "Board.h"
+#include "BoardPopulation.h"
+#include "Solver.h"
+
+/*
+* This struct holds the outcome of a run on a Board<BOX>.
+*/
+template <int BOX>
+struct BoardResult {
+   Board<BOX> best;               // best board found
+   int fitness = -1;              // fitness score of best
+   int generations = 0;           // generations that were run
+};
+
+/*
+* This function throws a runtime_error naming the first setting in
+* options that solveBoard cannot use for boards bigger than 9x9 (anything
+* but the population size, generation limit, cull percent, seed, mutation
+* rate and propagation, which bigger boards never do).
+*/
+void checkBoardOptions(const SolverOptions& options);
+
+/*
+* This function runs the genetic algorithm on puzzle using options and
+* returns the best board found. Throws a runtime_error if options holds a
+* setting that only applies to 9x9 puzzles (see checkBoardOptions).
+*/
+template <int BOX>
+BoardResult<BOX> solveBoard(const Board<BOX>& puzzle,
+   const SolverOptions& options) {
+   checkBoardOptions(options);
+   BoardPopulation<BOX> pop(puzzle, options.popSize, options.seed);
+   pop.setMutationPercent(options.mutationPercent);
+
+   BoardResult<BOX> result;
+   for (int i = 1; i <= options.maxGens && pop.bestFitness() != 0; i++) {
+      result.generations = i;
+      pop.cull(options.cullPercent);
+      pop.newGeneration();
+   }
+
+   result.best = pop.bestBoard();
+   result.fitness = pop.bestFitness();
+   return result;
+}
+
+/*
+* The 9x9 fast path (see BoardSolver.cpp).
+*/
+template <>
+BoardResult<3> solveBoard<3>(const Board<3>& puzzle,
+   const SolverOptions& options);
@@ -0,0 +1,84 @@
+/*
+* BoardTables.h
+* Timothy Kozlov, Eric Pham
+*
+* This header builds the lookup tables of SudokuTables.h for a board of any
+* size at compile time. BOX is the width of a box, so a board has
+* SIZE = BOX * BOX rows, columns, boxes and digits (BOX = 3 is the usual
+* 9x9 sudoku, 4 is 16x16 and 5 is 25x25). Cells are numbered row * SIZE +
+* col. Units are numbered like in SudokuTables.h: rows first, then
+* columns, then boxes.
+*/
+
+#pragma once
+
+template <int BOX>
+struct BoardTables {
+   static constexpr int SIZE = BOX * BOX;
+   static constexpr int CELLS = SIZE * SIZE;
+   static constexpr int UNITS = 3 * SIZE;
+
+   /*
+   * The SIZE cells that make up each unit.
+   */
+   unsigned short unitCells[UNITS][SIZE];
+
+   /*
+   * The row, column and box unit that each cell belongs to.
+   */
+   unsigned char cellUnits[CELLS][3];
+
+   /*
+   * One random 64-bit key per cell and digit (0 is the empty cell), used
+   * for Zobrist hashing just like SudokuTables#zobrist.
+   */
+   unsigned long long zobrist[CELLS][SIZE + 1];
+};
+
+/*
+* This function fills in the tables of a board with boxes BOX wide. It is
+* constexpr so that the tables are computed by the compiler.
+*/
+template <int BOX>
+constexpr BoardTables<BOX> makeBoardTables() {
+   constexpr int SIZE = BoardTables<BOX>::SIZE;
+   BoardTables<BOX> tables = {};
+
+   // State of the splitmix64 generator used for the Zobrist keys
+   unsigned long long state = 0x5D0CB7A3E1F29B47ULL + BOX;
+
+   // Invariant: 0 <= cell < CELLS
+   for (int cell = 0; cell < BoardTables<BOX>::CELLS; cell++) {
+      int row = cell / SIZE;
+      int col = cell % SIZE;
+      int box = (row / BOX) * BOX + col / BOX;
+
+      // Each cell belongs to one row, column and box
+      tables.cellUnits[cell][0] = row;
+      tables.cellUnits[cell][1] = SIZE + col;
+      tables.cellUnits[cell][2] = 2 * SIZE + box;
+
+      // Position of the cell inside each of its units
+      tables.unitCells[row][col] = cell;
+      tables.unitCells[SIZE + col][row] = cell;
+      tables.unitCells[2 * SIZE + box][(row % BOX) * BOX + col % BOX] = cell;
+
+      // Give every digit of the cell its own random key (splitmix64)
+      // Invariant: 0 <= digit <= SIZE
+      for (int digit = 0; digit <= SIZE; digit++) {
+         state += 0x9E3779B97F4A7C15ULL;
+         unsigned long long z = state;
+         z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+         z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+         tables.zobrist[cell][digit] = z ^ (z >> 31);
+      }
+   }
+
+   return tables;
+}
+
+/*
+* The tables themselves, one set per board size that is used.
+*/
+template <int BOX>
+inline constexpr BoardTables<BOX> BOARD_TABLES = makeBoardTables<BOX>();
@@ -0,0 +1,85 @@
+/*
+* BufferedWriter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class collects output in a fixed-size buffer and only writes it to
+* the underlying FILE when the buffer fills up or flush is called. It is
+* much cheaper than printing each line with cout and endl (which flushes
+* every time), so it is used for batch results and other large outputs.
+* It is not thread safe; callers that share one must lock around it.
+*/
+
+#include "BufferedWriter.h"
+
+/*
+* The constructor writes to file (which it does not own or close) using a
+* buffer of the given number of bytes.
+*/
+BufferedWriter::BufferedWriter(FILE* file, int capacity) : file_(file),
+   capacity_(capacity < 64 ? 64 : capacity), used_(0) {
+   buffer_ = new char[capacity_];
+}
+
+/*
+* The destructor flushes whatever is left and deallocates the buffer.
+*/
+BufferedWriter::~BufferedWriter() {
+   flush();
+   delete[] buffer_;
+}
+
+/*
+* These methods append text to the buffer.
+*/
+void BufferedWriter::write(const char* text, int length) {
+   // Text bigger than the whole buffer goes straight to the file
+   if (length > capacity_) {
+      flush();
+      fwrite(text, 1, length, file_);
+      return;
+   }
+
+   // Make room, then copy
+   if (used_ + length > capacity_) {
+      fwrite(buffer_, 1, used_, file_);
+      used_ = 0;
+   }
+   for (int i = 0; i < length; i++) {
+      buffer_[used_ + i] = text[i];
+   }
+   used_ += length;
+}
+
+void BufferedWriter::write(const string& text) {
+   write(text.data(), (int) text.size());
+}
+
+void BufferedWriter::write(char c) {
+   write(&c, 1);
+}
+
+/*
+* These methods append a number in decimal to the buffer.
+*/
+void BufferedWriter::writeInt(long long value) {
+   char digits[24];
+   int length = snprintf(digits, sizeof(digits), "%lld", value);
+   write(digits, length);
+}
+
+void BufferedWriter::writeDouble(double value, int decimals) {
+   char digits[64];
+   int length = snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+   write(digits, length < (int) sizeof(digits) ? length : 63);
+}
+
+/*
+* This method writes the buffer out to the file and flushes the file.
+*/
+void BufferedWriter::flush() {
+   if (used_ > 0) {
+      fwrite(buffer_, 1, used_, file_);
+      used_ = 0;
+   }
+   fflush(file_);
+}
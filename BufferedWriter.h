@@ -0,0 +1,61 @@
+/*
+* BufferedWriter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class collects output in a fixed-size buffer and only writes it to
+* the underlying FILE when the buffer fills up or flush is called. It is
+* much cheaper than printing each line with cout and endl (which flushes
+* every time), so it is used for batch results and other large outputs.
+* It is not thread safe; callers that share one must lock around it.
+*/
+
+#pragma once
+#include <cstdio>
+#include <string>
+using namespace std;
+
+class BufferedWriter
+{
+public:
+   /*
+   * The constructor writes to file (which it does not own or close) using a
+   * buffer of the given number of bytes.
+   */
+   explicit BufferedWriter(FILE* file, int capacity = 1 << 16);
+
+   /*
+   * The destructor flushes whatever is left and deallocates the buffer.
+   */
+   ~BufferedWriter();
+
+   /*
+   * These methods append text to the buffer.
+   */
+   void write(const char* text, int length);
+   void write(const string& text);
+   void write(char c);
+
+   /*
+   * These methods append a number in decimal to the buffer.
+   */
+   void writeInt(long long value);
+   void writeDouble(double value, int decimals);
+
+   /*
+   * This method writes the buffer out to the file and flushes the file.
+   */
+   void flush();
+
+private:
+   /*
+   * The FILE that output goes to.
+   */
+   FILE* file_;
+
+   /*
+   * The buffer, its size and how much of it is used.
+   */
+   char* buffer_;
+   int capacity_;
+   int used_;
+};
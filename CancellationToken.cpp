@@ -0,0 +1,77 @@
+/*
+* CancellationToken.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class lets a caller stop a run early. The generation loops check
+* isCancelled once per generation and return the best puzzle found so far
+* as soon as it is true. A token is cancelled when:
+*    - cancel is called (from any thread)
+*    - its deadline has passed, if it was given a time budget
+*    - its parent token is cancelled
+* solve makes its own token for --time-limit with the caller's token as the
+* parent, so either one stops the run. Checking a token is one atomic load
+* plus one clock read when it has a deadline.
+*/
+
+#include "CancellationToken.h"
+#include <algorithm>
+#include <limits>
+
+/*
+* This constructor makes a token with no deadline and no parent. It is
+* only cancelled by cancel.
+*/
+CancellationToken::CancellationToken()
+   : cancelled_(false), hasDeadline_(false), parent_(nullptr) {
+}
+
+/*
+* This constructor makes a token whose deadline is the given number of
+* milliseconds from now (0 or less for no deadline) and which is also
+* cancelled whenever parent is (nullptr for no parent). The parent must
+* outlive the token.
+*/
+CancellationToken::CancellationToken(double milliseconds,
+   const CancellationToken* parent)
+   : cancelled_(false), hasDeadline_(milliseconds > 0), parent_(parent) {
+   if (hasDeadline_) {
+      deadline_ = chrono::steady_clock::now()
+         + chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double, milli>(milliseconds));
+   }
+}
+
+/*
+* This method cancels the token. It is safe to call from any thread.
+*/
+void CancellationToken::cancel() {
+   cancelled_.store(true, memory_order_relaxed);
+}
+
+/*
+* This method returns true if cancel was called, the deadline has passed
+* or the parent was cancelled. Once it returns true it always does.
+*/
+bool CancellationToken::isCancelled() const {
+   if (cancelled_.load(memory_order_relaxed)) {
+      return true;
+   }
+   if (hasDeadline_ && chrono::steady_clock::now() >= deadline_) {
+      return true;
+   }
+   return parent_ != nullptr && parent_->isCancelled();
+}
+
+/*
+* This method returns the seconds left before the deadline, or a huge
+* number if the token has no deadline.
+*/
+double CancellationToken::remainingSeconds() const {
+   double remaining = parent_ != nullptr ? parent_->remainingSeconds()
+      : numeric_limits<double>::max();
+   if (hasDeadline_) {
+      chrono::duration<double> left = deadline_ - chrono::steady_clock::now();
+      remaining = min(remaining, left.count());
+   }
+   return remaining;
+}
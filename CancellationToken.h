@@ -0,0 +1,71 @@
+/*
+* CancellationToken.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class lets a caller stop a run early. The generation loops check
+* isCancelled once per generation and return the best puzzle found so far
+* as soon as it is true. A token is cancelled when:
+*    - cancel is called (from any thread)
+*    - its deadline has passed, if it was given a time budget
+*    - its parent token is cancelled
+* solve makes its own token for --time-limit with the caller's token as the
+* parent, so either one stops the run. Checking a token is one atomic load
+* plus one clock read when it has a deadline.
+*/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+class CancellationToken
+{
+public:
+   /*
+   * This constructor makes a token with no deadline and no parent. It is
+   * only cancelled by cancel.
+   */
+   CancellationToken();
+
+   /*
+   * This constructor makes a token whose deadline is the given number of
+   * milliseconds from now (0 or less for no deadline) and which is also
+   * cancelled whenever parent is (nullptr for no parent). The parent must
+   * outlive the token.
+   */
+   CancellationToken(double milliseconds, const CancellationToken* parent);
+
+   /*
+   * This method cancels the token. It is safe to call from any thread.
+   */
+   void cancel();
+
+   /*
+   * This method returns true if cancel was called, the deadline has passed
+   * or the parent was cancelled. Once it returns true it always does.
+   */
+   bool isCancelled() const;
+
+   /*
+   * This method returns the seconds left before the deadline, or a huge
+   * number if the token has no deadline.
+   */
+   double remainingSeconds() const;
+
+private:
+   /*
+   * This field is set by cancel.
+   */
+   atomic<bool> cancelled_;
+
+   /*
+   * These fields are the deadline, if hasDeadline_ is true.
+   */
+   bool hasDeadline_;
+   chrono::steady_clock::time_point deadline_;
+
+   /*
+   * This field is the token this one follows (nullptr for none).
+   */
+   const CancellationToken* parent_;
+};
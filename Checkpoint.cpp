@@ -0,0 +1,56 @@
+/*
+* Checkpoint.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These declarations describe the binary checkpoint that a long run can be
+* saved to and resumed from (see SudokuPopulation#saveCheckpoint and
+* #loadCheckpoint). A checkpoint file is laid out as:
+*
+*    CheckpointHeader
+*    81 bytes     the original puzzle's digits, 0 where not fixed (this is
+*                 the fixed mask, stored once)
+*    81 shorts    the candidate masks, only if hasCandidates is set
+*    41 bytes     per board, packed 4 bits per cell (CompactSudoku#pack)
+*    1 int        per board, its fitness score
+*
+* Every random stream of a population is derived from its seed and the
+* generation counter (see Random#stream), so those two numbers are the
+* whole random state. The numbers are written in the machine's own byte
+* order, so a checkpoint is meant to be resumed on the same kind of
+* machine.
+*
+* This file also lets a run stop cleanly on SIGTERM: watchTermination
+* installs a handler that only sets a flag, and the generation loop checks
+* terminationRequested after every generation so it can save a checkpoint
+* before exiting.
+*/
+
+#include "Checkpoint.h"
+#include <csignal>
+
+// Set by the signal handler, read by the generation loop
+static volatile sig_atomic_t terminated = 0;
+
+/*
+* This helper is the SIGTERM handler. Setting a flag is all a signal
+* handler can safely do.
+*/
+static void onTerminate(int) {
+   terminated = 1;
+}
+
+/*
+* This function installs a SIGTERM handler that makes terminationRequested
+* return true. It is safe to call more than once.
+*/
+void watchTermination() {
+   signal(SIGTERM, onTerminate);
+}
+
+/*
+* This function returns true once SIGTERM has been received (after
+* watchTermination was called).
+*/
+bool terminationRequested() {
+   return terminated != 0;
+}
@@ -0,0 +1,70 @@
+/*
+* Checkpoint.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These declarations describe the binary checkpoint that a long run can be
+* saved to and resumed from (see SudokuPopulation#saveCheckpoint and
+* #loadCheckpoint). A checkpoint file is laid out as:
+*
+*    CheckpointHeader
+*    81 bytes     the original puzzle's digits, 0 where not fixed (this is
+*                 the fixed mask, stored once)
+*    81 shorts    the candidate masks, only if hasCandidates is set
+*    41 bytes     per board, packed 4 bits per cell (CompactSudoku#pack)
+*    1 int        per board, its fitness score
+*
+* Every random stream of a population is derived from its seed and the
+* generation counter (see Random#stream), so those two numbers are the
+* whole random state. The numbers are written in the machine's own byte
+* order, so a checkpoint is meant to be resumed on the same kind of
+* machine.
+*
+* This file also lets a run stop cleanly on SIGTERM: watchTermination
+* installs a handler that only sets a flag, and the generation loop checks
+* terminationRequested after every generation so it can save a checkpoint
+* before exiting.
+*/
+
+#pragma once
+#include "SudokuPopulation.h"
+#include "AdaptiveController.h"
+#include <type_traits>
+
+// First bytes of every checkpoint file, and the current layout version
+const char CHECKPOINT_MAGIC[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'C', 'P' };
+const int CHECKPOINT_VERSION = 1;
+
+/*
+* This struct is the fixed-size start of a checkpoint file.
+*/
+struct CheckpointHeader {
+   char magic[8];                 // CHECKPOINT_MAGIC
+   int version;                   // CHECKPOINT_VERSION
+   int boardCount;                // boards in the population
+   int chunkSize;                 // puzzles per random stream
+   int reserved;                  // always 0, fills the gap before generation
+   long long generation;          // generations run so far
+   unsigned long long seed;       // seed every random stream comes from
+   int encoding;                  // Encoding of the population
+   int mutationPercent;           // current mutation rate
+   int bestIndex;                 // index of the best board
+   int hasCandidates;             // 1 if candidate masks follow
+   PopulationStats stats;         // counters collected so far
+   AdaptiveState adaptive;        // state of the AdaptiveController
+};
+
+// The header is written and read as raw bytes
+static_assert(std::is_trivially_copyable<CheckpointHeader>::value,
+   "CheckpointHeader must be trivially copyable");
+
+/*
+* This function installs a SIGTERM handler that makes terminationRequested
+* return true. It is safe to call more than once.
+*/
+void watchTermination();
+
+/*
+* This function returns true once SIGTERM has been received (after
+* watchTermination was called).
+*/
+bool terminationRequested();
@@ -0,0 +1,168 @@
+/*
+* CompactSudoku.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These classes store sudoku boards in as little memory as possible so that
+* very large populations fit in memory. A Sudoku keeps 81 ints, 81 bools,
+* its unit counts, hash and fitness delta, but every board in a population
+* shares the same fixed cells and only needs the unit counts while it is
+* being changed. A CompactSudoku keeps just one byte per cell (81 bytes);
+* which cells are fixed is kept once per population in a FixedMask. It can
+* also be packed further into 4 bits per cell (41 bytes) for storage.
+*
+* SudokuPopulation stores every board this way. A board is unpacked into a
+* scratch Sudoku (see copyTo) only while offspring are made from it, so the
+* unit counts that delta scoring needs exist once per chunk instead of once
+* per board.
+*
+* CompactSudoku is trivially copyable, so copying or cloning one is a plain
+* memcpy.
+*/
+
+#include "CompactSudoku.h"
+#include "SudokuTables.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+* This is the default constructor. No cells are fixed.
+*/
+FixedMask::FixedMask() : bits_{ 0, 0 } { }
+
+/*
+* This constructor copies which cells are fixed out of a Sudoku puzzle
+* (normally the original puzzle the population was built from).
+*/
+FixedMask::FixedMask(const Sudoku& original) : bits_{ 0, 0 } {
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      if (original.isFixed(cell / 9, cell % 9)) {
+         bits_[cell / 64] |= 1ULL << (cell % 64);
+      }
+   }
+}
+
+/*
+* This method returns true if the cell (row * 9 + col) is fixed.
+*/
+bool FixedMask::isFixed(int cell) const {
+   return (bits_[cell / 64] >> (cell % 64)) & 1;
+}
+
+/*
+* This is the default constructor. It represents an empty board.
+*/
+CompactSudoku::CompactSudoku() : cells_{ 0 } { }
+
+/*
+* This constructor copies the digits of a Sudoku.
+*/
+CompactSudoku::CompactSudoku(const Sudoku& sudoku) {
+   const int* cells = sudoku.getCells();
+
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      cells_[cell] = (unsigned char) cells[cell];
+   }
+}
+
+/*
+* This method writes the digits of this board into sudoku, which must have
+* been copied from the same original puzzle (so its fixed cells match).
+* The unit counts and hash of sudoku are rebuilt and its fitness delta is
+* cleared.
+*/
+void CompactSudoku::copyTo(Sudoku& sudoku) const {
+   sudoku.setCells(cells_);
+}
+
+/*
+* This method returns the digit stored at row and col.
+*/
+int CompactSudoku::getDigitAt(int row, int col) const {
+   // Check bounds
+   if (row < 0 || row >= 9 || col < 0 || col >= 9) {
+      throw runtime_error("Invalid bounds for getDigitAt");
+   }
+
+   return cells_[row * 9 + col];
+}
+
+/*
+* This method sets the digit at row and col as long as fixed (the mask
+* shared by the population) says it is not fixed. Returns false if the
+* cell is fixed.
+*/
+bool CompactSudoku::setDigitAt(int row, int col, int digit,
+   const FixedMask& fixed) {
+   // Check bounds
+   if (row < 0 || row >= 9 || col < 0 || col >= 9) {
+      throw runtime_error("Invalid bounds for setDigitAt");
+   }
+
+   // Check that digit is legal
+   if (digit <= 0 || digit > 9) {
+      throw runtime_error("Invalid domain for sudoku digit in setDigitAt");
+   }
+
+   // Check if cell is fixed
+   if (fixed.isFixed(row * 9 + col)) {
+      return false; // Cannot be changed, return false
+   }
+
+   cells_[row * 9 + col] = (unsigned char) digit;
+   return true;
+}
+
+/*
+* This method returns a pointer to the 81 digits in row-major order.
+*/
+const unsigned char* CompactSudoku::getCells() const {
+   return cells_;
+}
+
+/*
+* This method returns the Zobrist hash of the digits, the same value
+* Sudoku#getHash gives for a board with the same digits.
+*/
+unsigned long long CompactSudoku::getHash() const {
+   unsigned long long hash = 0;
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      hash ^= SUDOKU_TABLES.zobrist[cell][cells_[cell]];
+   }
+   return hash;
+}
+
+/*
+* This method packs the board into PACKED_SIZE bytes, two cells per byte
+* (low nibble first). The fixed mask is not included.
+*/
+void CompactSudoku::pack(unsigned char* out) const {
+   // Invariant: 0 <= i < PACKED_SIZE
+   for (int i = 0; i < PACKED_SIZE; i++) {
+      // The last byte only has one cell in it
+      unsigned char high = 2 * i + 1 < 81 ? cells_[2 * i + 1] : 0;
+      out[i] = (unsigned char)(cells_[2 * i] | (high << 4));
+   }
+}
+
+/*
+* This method restores the board from PACKED_SIZE bytes written by pack.
+* Returns false, leaving the board unchanged, if any cell is not a digit
+* 0-9.
+*/
+bool CompactSudoku::unpack(const unsigned char* in) {
+   // Check every digit before changing the board
+   unsigned char digits[81];
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      digits[cell] = (in[cell / 2] >> (4 * (cell % 2))) & 0xF;
+      if (digits[cell] > 9) {
+         return false;
+      }
+   }
+
+   copy(digits, digits + 81, cells_);
+   return true;
+}
@@ -0,0 +1,126 @@
+/*
+* CompactSudoku.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These classes store sudoku boards in as little memory as possible so that
+* very large populations fit in memory. A Sudoku keeps 81 ints, 81 bools,
+* its unit counts, hash and fitness delta, but every board in a population
+* shares the same fixed cells and only needs the unit counts while it is
+* being changed. A CompactSudoku keeps just one byte per cell (81 bytes);
+* which cells are fixed is kept once per population in a FixedMask. It can
+* also be packed further into 4 bits per cell (41 bytes) for storage.
+*
+* SudokuPopulation stores every board this way. A board is unpacked into a
+* scratch Sudoku (see copyTo) only while offspring are made from it, so the
+* unit counts that delta scoring needs exist once per chunk instead of once
+* per board.
+*
+* CompactSudoku is trivially copyable, so copying or cloning one is a plain
+* memcpy.
+*/
+
+#pragma once
+#include <type_traits>
+#include "Sudoku.h"
+
+class FixedMask
+{
+public:
+   /*
+   * This is the default constructor. No cells are fixed.
+   */
+   FixedMask();
+
+   /*
+   * This constructor copies which cells are fixed out of a Sudoku puzzle
+   * (normally the original puzzle the population was built from).
+   */
+   explicit FixedMask(const Sudoku& original);
+
+   /*
+   * This method returns true if the cell (row * 9 + col) is fixed.
+   */
+   bool isFixed(int cell) const;
+
+private:
+   /*
+   * This variable holds one bit per cell. Cells 0-63 are in bits_[0] and
+   * cells 64-80 are in bits_[1].
+   */
+   unsigned long long bits_[2];
+};
+
+class CompactSudoku
+{
+public:
+   /*
+   * This is the number of bytes a board takes up when packed at 4 bits
+   * per cell by pack.
+   */
+   static const int PACKED_SIZE = 41;
+
+   /*
+   * This is the default constructor. It represents an empty board.
+   */
+   CompactSudoku();
+
+   /*
+   * This constructor copies the digits of a Sudoku.
+   */
+   explicit CompactSudoku(const Sudoku& sudoku);
+
+   /*
+   * This method writes the digits of this board into sudoku, which must have
+   * been copied from the same original puzzle (so its fixed cells match).
+   * The unit counts and hash of sudoku are rebuilt and its fitness delta is
+   * cleared.
+   */
+   void copyTo(Sudoku& sudoku) const;
+
+   /*
+   * This method returns the digit stored at row and col.
+   */
+   int getDigitAt(int row, int col) const;
+
+   /*
+   * This method sets the digit at row and col as long as fixed (the mask
+   * shared by the population) says it is not fixed. Returns false if the
+   * cell is fixed.
+   */
+   bool setDigitAt(int row, int col, int digit, const FixedMask& fixed);
+
+   /*
+   * This method returns a pointer to the 81 digits in row-major order.
+   */
+   const unsigned char* getCells() const;
+
+   /*
+   * This method returns the Zobrist hash of the digits, the same value
+   * Sudoku#getHash gives for a board with the same digits.
+   */
+   unsigned long long getHash() const;
+
+   /*
+   * This method packs the board into PACKED_SIZE bytes, two cells per byte
+   * (low nibble first). The fixed mask is not included.
+   */
+   void pack(unsigned char* out) const;
+
+   /*
+   * This method restores the board from PACKED_SIZE bytes written by pack.
+   * Returns false, leaving the board unchanged, if any cell is not a digit
+   * 0-9.
+   */
+   bool unpack(const unsigned char* in);
+
+private:
+   /*
+   * This variable holds one digit 0-9 per cell in row-major order.
+   */
+   unsigned char cells_[81];
+};
+
+static_assert(is_trivially_copyable<CompactSudoku>::value,
+   "CompactSudoku must be copyable with memcpy");
+static_assert(sizeof(CompactSudoku) == 81,
+   "CompactSudoku must hold nothing but its cells");
@@ -0,0 +1,156 @@
+/*
+* ConstraintPropagator.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class shrinks a puzzle before the genetic algorithm starts. It works
+* out which digits can still go in every cell (a candidate mask, bit d set
+* for digit d) and then repeatedly fills in forced cells:
+*    - naked singles: a cell with only one candidate left
+*    - hidden singles: a digit that fits in only one cell of a row, column
+*      or box
+* Every forced cell becomes fixed, and the candidates that are left are
+* used by SudokuFactory and SudokuOffspring to draw digits, so easy puzzles
+* are solved here without any generations.
+*/
+
+#include "ConstraintPropagator.h"
+#include "SudokuTables.h"
+#include <bitset>
+
+// Candidate mask with every digit 1-9 allowed
+const unsigned short ALL_DIGITS = 0x3FE;
+
+/*
+* This helper places digit in cell and removes it from the candidates of
+* every peer. Returns false if a peer that is still empty runs out of
+* candidates or already holds digit.
+*/
+static bool place(unsigned char* cells, unsigned short* candidates, int cell,
+   int digit) {
+   unsigned short bit = (unsigned short)(1 << digit);
+   cells[cell] = (unsigned char) digit;
+   candidates[cell] = bit;
+
+   // Invariant: 0 <= i < 20
+   for (int i = 0; i < 20; i++) {
+      int peer = SUDOKU_TABLES.cellPeers[cell][i];
+      if (cells[peer] == digit) {
+         return false;
+      }
+      if (cells[peer] == 0) {
+         candidates[peer] &= (unsigned short) ~bit;
+         if (candidates[peer] == 0) {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+ConstraintPropagator& ConstraintPropagator::getInstance() {
+   // Create a static instance
+   static ConstraintPropagator instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method fills every forced cell of puzzle (only its fixed cells
+* count as clues) and marks them fixed. candidates must have room for 81
+* masks; it is filled with the digits that can still go in each cell
+* (a single bit for fixed cells). Returns false if the clues contradict
+* each other, which means the puzzle has no solution.
+*/
+bool ConstraintPropagator::propagate(Sudoku& puzzle,
+   unsigned short* candidates) const {
+   unsigned char cells[81] = { 0 };
+   const int* digits = puzzle.getCells();
+   bool valid = true;
+
+   // Start with every digit allowed, then place the clues
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      candidates[cell] = ALL_DIGITS;
+   }
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81 && valid; cell++) {
+      if (puzzle.isFixed(cell / 9, cell % 9)) {
+         valid = place(cells, candidates, cell, digits[cell]);
+      }
+   }
+
+   // Keep placing singles until nothing changes
+   bool changed = valid;
+   while (changed && valid) {
+      changed = false;
+
+      // Naked singles
+      // Invariant: 0 <= cell < 81
+      for (int cell = 0; cell < 81 && valid; cell++) {
+         if (cells[cell] == 0 && bitset<16>(candidates[cell]).count() == 1) {
+            int digit = (int) bitset<16>(candidates[cell] - 1).count();
+            valid = place(cells, candidates, cell, digit);
+            changed = true;
+         }
+      }
+
+      // Hidden singles
+      // Invariant: 0 <= unit < 27
+      for (int unit = 0; unit < 27 && valid; unit++) {
+         const unsigned char* unitCells = SUDOKU_TABLES.unitCells[unit];
+
+         // Invariant: 1 <= digit <= 9
+         for (int digit = 1; digit <= 9 && valid; digit++) {
+            unsigned short bit = (unsigned short)(1 << digit);
+            int where = -1;
+            int count = 0;
+            // Invariant: 0 <= i < 9
+            for (int i = 0; i < 9; i++) {
+               if (candidates[unitCells[i]] & bit) {
+                  where = unitCells[i];
+                  count++;
+               }
+            }
+
+            // A digit with nowhere to go means there is no solution
+            if (count == 0) {
+               valid = false;
+            } else if (count == 1 && cells[where] == 0) {
+               valid = place(cells, candidates, where, digit);
+               changed = true;
+            }
+         }
+      }
+   }
+
+   // Write the forced cells back as clues (loadCells fixes every digit)
+   if (valid) {
+      puzzle.loadCells(cells);
+   }
+
+   return valid;
+}
+
+/*
+* This helper returns a digit picked uniformly from the bits of mask
+* using rng. If mask has no digits set, a digit 1-9 is picked instead.
+*/
+int ConstraintPropagator::pickCandidate(unsigned short mask, Random& rng) {
+   int count = (int) bitset<16>(mask).count();
+   if (count == 0) {
+      return rng.nextInt(9) + 1;
+   }
+
+   // Skip to the k-th set bit
+   int k = rng.nextInt(count);
+   // Invariant: k set bits are left to skip
+   for (; k > 0; k--) {
+      mask &= (unsigned short)(mask - 1);
+   }
+   return (int) bitset<16>((mask & (unsigned short) -mask) - 1).count();
+}
@@ -0,0 +1,42 @@
+/*
+* ConstraintPropagator.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class shrinks a puzzle before the genetic algorithm starts. It works
+* out which digits can still go in every cell (a candidate mask, bit d set
+* for digit d) and then repeatedly fills in forced cells:
+*    - naked singles: a cell with only one candidate left
+*    - hidden singles: a digit that fits in only one cell of a row, column
+*      or box
+* Every forced cell becomes fixed, and the candidates that are left are
+* used by SudokuFactory and SudokuOffspring to draw digits, so easy puzzles
+* are solved here without any generations.
+*/
+
+#pragma once
+#include "Random.h"
+#include "Sudoku.h"
+
+class ConstraintPropagator
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static ConstraintPropagator& getInstance();
+
+   /*
+   * This method fills every forced cell of puzzle (only its fixed cells
+   * count as clues) and marks them fixed. candidates must have room for 81
+   * masks; it is filled with the digits that can still go in each cell
+   * (a single bit for fixed cells). Returns false if the clues contradict
+   * each other, which means the puzzle has no solution.
+   */
+   bool propagate(Sudoku& puzzle, unsigned short* candidates) const;
+
+   /*
+   * This helper returns a digit picked uniformly from the bits of mask
+   * using rng. If mask has no digits set, a digit 1-9 is picked instead.
+   */
+   static int pickCandidate(unsigned short mask, Random& rng);
+};
@@ -0,0 +1,76 @@
+/*
+* DuplicateFilter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class remembers the Zobrist hashes of the boards in the generation
+* that is being built, so SudokuPopulation#newGeneration can tell when an
+* offspring is identical to a board that is already in it. It is an open
+* addressing hash set sized for a whole population. Every slot is stamped
+* with the generation it was written in, so starting a new generation is
+* O(1) instead of clearing the table.
+*/
+
+#include "DuplicateFilter.h"
+
+/*
+* The constructor allocates a set big enough to hold the hashes of a
+* population of the given size.
+*/
+DuplicateFilter::DuplicateFilter(int populationSize) : stamp_(1) {
+   // Keep the set at most half full so probes stay short
+   unsigned long long size = 1;
+   while (size < 2 * (unsigned long long) populationSize) {
+      size *= 2;
+   }
+
+   hashes_ = new unsigned long long[size];
+   stamps_ = new unsigned int[size];
+   mask_ = size - 1;
+
+   // Stamp 0 is never current, so every slot starts out empty
+   for (unsigned long long i = 0; i < size; i++) {
+      stamps_[i] = 0;
+   }
+}
+
+/*
+* The destructor deallocates the set.
+*/
+DuplicateFilter::~DuplicateFilter() {
+   delete[] hashes_;
+   delete[] stamps_;
+}
+
+/*
+* This method forgets every hash by moving on to a new generation stamp.
+*/
+void DuplicateFilter::clear() {
+   stamp_++;
+
+   // If the stamp wraps around, old stamps could look current again
+   if (stamp_ == 0) {
+      for (unsigned long long i = 0; i <= mask_; i++) {
+         stamps_[i] = 0;
+      }
+      stamp_ = 1;
+   }
+}
+
+/*
+* This method adds hash to the set. Returns false (and does nothing) if
+* it was already there, true if it was added.
+*/
+bool DuplicateFilter::insert(unsigned long long hash) {
+   // Linear probing starting from the low bits of the hash
+   unsigned long long slot = hash & mask_;
+   while (stamps_[slot] == stamp_) {
+      if (hashes_[slot] == hash) {
+         return false;
+      }
+      slot = (slot + 1) & mask_;
+   }
+
+   hashes_[slot] = hash;
+   stamps_[slot] = stamp_;
+   return true;
+}
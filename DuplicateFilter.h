@@ -0,0 +1,57 @@
+/*
+* DuplicateFilter.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class remembers the Zobrist hashes of the boards in the generation
+* that is being built, so SudokuPopulation#newGeneration can tell when an
+* offspring is identical to a board that is already in it. It is an open
+* addressing hash set sized for a whole population. Every slot is stamped
+* with the generation it was written in, so starting a new generation is
+* O(1) instead of clearing the table.
+*/
+
+#pragma once
+
+class DuplicateFilter
+{
+public:
+   /*
+   * The constructor allocates a set big enough to hold the hashes of a
+   * population of the given size.
+   */
+   explicit DuplicateFilter(int populationSize);
+
+   /*
+   * The destructor deallocates the set.
+   */
+   ~DuplicateFilter();
+
+   /*
+   * This method forgets every hash by moving on to a new generation stamp.
+   */
+   void clear();
+
+   /*
+   * This method adds hash to the set. Returns false (and does nothing) if
+   * it was already there, true if it was added.
+   */
+   bool insert(unsigned long long hash);
+
+private:
+   /*
+   * These variables are the parallel arrays of hashes and the generation
+   * stamp of each slot. A slot only counts if its stamp equals stamp_.
+   */
+   unsigned long long* hashes_;
+   unsigned int* stamps_;
+
+   /*
+   * This variable is the number of slots minus one.
+   */
+   unsigned long long mask_;
+
+   /*
+   * This variable is the stamp of the current generation.
+   */
+   unsigned int stamp_;
+};
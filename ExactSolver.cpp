@@ -0,0 +1,179 @@
+/*
+* ExactSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class solves a sudoku exactly instead of searching for it with the
+* genetic algorithm. It keeps a 9-bit mask of the digits used by every row,
+* column and box and does a depth-first backtracking search. At each step
+* it fills the empty cell with the fewest candidates (minimum remaining
+* values), so forced cells are filled first and dead ends are found early.
+* It always finds a solution if there is one, unless it is cancelled
+* first: the search checks its CancellationToken every POLL_NODES cells
+* tried. It follows the singleton pattern like the other strategy classes.
+*/
+
+#include "ExactSolver.h"
+#include "SudokuTables.h"
+#include <bitset>
+
+/*
+* This struct holds the state of one search. used[unit] has bit d-1 set
+* when digit d is already in that unit (units as in SudokuTables.h).
+* stopped is set once cancel has been found cancelled.
+*/
+struct SearchState {
+   unsigned char cells[81];
+   unsigned short used[27];
+   long long nodes;
+   const CancellationToken* cancel;
+   bool stopped;
+};
+
+/*
+* This helper returns the digits (as bits 0-8) that can still go in cell.
+*/
+static unsigned short candidates(const SearchState& state, int cell) {
+   const unsigned char* units = SUDOKU_TABLES.cellUnits[cell];
+   unsigned short used = state.used[units[0]] | state.used[units[1]]
+      | state.used[units[2]];
+   return (unsigned short)(~used & 0x1FF);
+}
+
+/*
+* This helper fills every empty cell of state, trying the cell with the
+* fewest candidates first. Returns true once the board is full, or false
+* if some cell has no candidates left (the caller then backtracks) or the
+* search was stopped.
+*/
+static bool search(SearchState& state) {
+   // Find the empty cell with the fewest candidates
+   int best = -1;
+   int bestCount = 10;
+   unsigned short bestMask = 0;
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81 && bestCount > 1; cell++) {
+      if (state.cells[cell] != 0) {
+         continue;
+      }
+
+      unsigned short mask = candidates(state, cell);
+      int count = (int) bitset<9>(mask).count();
+      if (count == 0) {
+         return false; // Dead end
+      }
+      if (count < bestCount) {
+         best = cell;
+         bestCount = count;
+         bestMask = mask;
+      }
+   }
+
+   // No empty cells, so the board is solved
+   if (best == -1) {
+      return true;
+   }
+
+   const unsigned char* units = SUDOKU_TABLES.cellUnits[best];
+
+   // Try each candidate digit, lowest first
+   // Invariant: bestMask holds the candidates not tried yet
+   while (bestMask != 0) {
+      unsigned short bit = bestMask & (unsigned short)(-bestMask);
+      bestMask &= (unsigned short)(bestMask - 1);
+      int digit = (int) bitset<16>(bit - 1).count() + 1;
+
+      // Give up once the token is cancelled
+      if (state.cancel != nullptr
+         && state.nodes % ExactSolver::POLL_NODES == 0
+         && state.cancel->isCancelled()) {
+         state.stopped = true;
+      }
+      if (state.stopped) {
+         return false;
+      }
+
+      // Place the digit
+      state.nodes++;
+      state.cells[best] = (unsigned char) digit;
+      state.used[units[0]] |= bit;
+      state.used[units[1]] |= bit;
+      state.used[units[2]] |= bit;
+
+      if (search(state)) {
+         return true;
+      }
+
+      // Take it back out
+      state.cells[best] = 0;
+      state.used[units[0]] &= (unsigned short) ~bit;
+      state.used[units[1]] &= (unsigned short) ~bit;
+      state.used[units[2]] &= (unsigned short) ~bit;
+   }
+
+   return false;
+}
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+ExactSolver& ExactSolver::getInstance() {
+   // Create a static instance
+   static ExactSolver instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method casts puzzle to a Sudoku and solves it. If it has a
+* solution, the solved board is written into out (with the same fixed
+* cells as puzzle) and true is returned. Otherwise out is a copy of
+* puzzle and false is returned. If nodes is not nullptr, it is set to
+* the number of cells that were tried during the search. If cancel is
+* not nullptr, the search gives up (and returns false) once it is
+* cancelled.
+*/
+bool ExactSolver::solve(const Puzzle& puzzle, Sudoku& out, long long* nodes,
+   const CancellationToken* cancel) const {
+   const Sudoku& sudoku = *(const Sudoku*) &puzzle;
+   out = sudoku;
+
+   SearchState state = {};
+   state.cancel = cancel;
+   const int* cells = sudoku.getCells();
+   bool valid = true;
+
+   // Only the fixed cells are clues, anything else is searched again
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      if (!sudoku.isFixed(cell / 9, cell % 9)) {
+         continue;
+      }
+
+      unsigned short bit = (unsigned short)(1 << (cells[cell] - 1));
+      const unsigned char* units = SUDOKU_TABLES.cellUnits[cell];
+
+      // Two equal clues in one unit can never be solved
+      if ((state.used[units[0]] | state.used[units[1]]
+         | state.used[units[2]]) & bit) {
+         valid = false;
+      }
+
+      state.cells[cell] = (unsigned char) cells[cell];
+      state.used[units[0]] |= bit;
+      state.used[units[1]] |= bit;
+      state.used[units[2]] |= bit;
+   }
+
+   bool solved = valid && search(state);
+   if (nodes != nullptr) {
+      *nodes = state.nodes;
+   }
+
+   // Copy the solution over (setCells keeps the fixed cells)
+   if (solved) {
+      out.setCells(state.cells);
+   }
+
+   return solved;
+}
@@ -0,0 +1,44 @@
+/*
+* ExactSolver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class solves a sudoku exactly instead of searching for it with the
+* genetic algorithm. It keeps a 9-bit mask of the digits used by every row,
+* column and box and does a depth-first backtracking search. At each step
+* it fills the empty cell with the fewest candidates (minimum remaining
+* values), so forced cells are filled first and dead ends are found early.
+* It always finds a solution if there is one, unless it is cancelled
+* first: the search checks its CancellationToken every POLL_NODES cells
+* tried. It follows the singleton pattern like the other strategy classes.
+*/
+
+#pragma once
+#include "Puzzle.h"
+#include "Sudoku.h"
+#include "CancellationToken.h"
+
+class ExactSolver
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static ExactSolver& getInstance();
+
+   /*
+   * This is how many cells are tried between checks of the token.
+   */
+   static const long long POLL_NODES = 4096;
+
+   /*
+   * This method casts puzzle to a Sudoku and solves it. If it has a
+   * solution, the solved board is written into out (with the same fixed
+   * cells as puzzle) and true is returned. Otherwise out is a copy of
+   * puzzle and false is returned. If nodes is not nullptr, it is set to
+   * the number of cells that were tried during the search. If cancel is
+   * not nullptr, the search gives up (and returns false) once it is
+   * cancelled.
+   */
+   bool solve(const Puzzle& puzzle, Sudoku& out, long long* nodes = nullptr,
+      const CancellationToken* cancel = nullptr) const;
+};
@@ -0,0 +1,91 @@
+/*
+* FitnessCache.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is a bounded transposition table that maps the Zobrist hash of
+* a board (Sudoku#getHash) to its fitness score. It lasts across
+* generations, so a board that shows up again (for example an offspring
+* whose mutations all landed on fixed cells) does not need to be scored
+* again. The table is direct-mapped: each hash has exactly one slot and a
+* newer entry simply replaces an older one, so its size never grows.
+*
+* Each slot is a single atomic 64-bit word, so the table can be shared by
+* the threads of a ThreadPool without locks. Two threads racing on a slot
+* can only make a lookup miss; a hit always returns the score of that board.
+*/
+
+#include "FitnessCache.h"
+
+// The low 16 bits of a slot hold the score, the rest hold the hash
+const unsigned long long SCORE_BITS = 0xFFFF;
+
+/*
+* The constructor allocates room for at least the given number of entries
+* (rounded up to a power of two). All entries start out empty.
+*/
+FitnessCache::FitnessCache(int entries) : lookups_(0), hits_(0) {
+   // Round up to a power of two so a mask can pick the slot
+   unsigned long long size = 1;
+   while (size < (unsigned long long) entries) {
+      size *= 2;
+   }
+
+   entries_ = new atomic<unsigned long long>[size];
+   mask_ = size - 1;
+
+   // Mark every slot as empty
+   for (unsigned long long i = 0; i < size; i++) {
+      entries_[i].store(0, memory_order_relaxed);
+   }
+}
+
+/*
+* The destructor deallocates the table.
+*/
+FitnessCache::~FitnessCache() {
+   delete[] entries_;
+}
+
+/*
+* This method looks up hash. If it is in the table, score is set to the
+* stored fitness and true is returned. Otherwise returns false.
+*/
+bool FitnessCache::lookup(unsigned long long hash, int& score) {
+   lookups_.fetch_add(1, memory_order_relaxed);
+
+   // The low bits of a Zobrist hash are already random, use them as index
+   unsigned long long entry = entries_[hash & mask_].load(memory_order_relaxed);
+   if (entry == 0 || (entry & ~SCORE_BITS) != (hash & ~SCORE_BITS)) {
+      return false;
+   }
+
+   hits_.fetch_add(1, memory_order_relaxed);
+   score = (int)(entry & SCORE_BITS) - 1;
+   return true;
+}
+
+/*
+* This method stores the fitness score of hash, replacing whatever was in
+* its slot.
+*/
+void FitnessCache::store(unsigned long long hash, int score) {
+   // Scores that do not fit in the low bits are simply not cached
+   if (score < 0 || score + 1 > (int) SCORE_BITS) {
+      return;
+   }
+
+   unsigned long long entry = (hash & ~SCORE_BITS)
+      | (unsigned long long)(score + 1);
+   entries_[hash & mask_].store(entry, memory_order_relaxed);
+}
+
+/*
+* These methods return the number of lookups and how many of them hit.
+*/
+long long FitnessCache::getLookups() const {
+   return lookups_.load();
+}
+
+long long FitnessCache::getHits() const {
+   return hits_.load();
+}
@@ -0,0 +1,72 @@
+/*
+* FitnessCache.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is a bounded transposition table that maps the Zobrist hash of
+* a board (Sudoku#getHash) to its fitness score. It lasts across
+* generations, so a board that shows up again (for example an offspring
+* whose mutations all landed on fixed cells) does not need to be scored
+* again. The table is direct-mapped: each hash has exactly one slot and a
+* newer entry simply replaces an older one, so its size never grows.
+*
+* Each slot is a single atomic 64-bit word, so the table can be shared by
+* the threads of a ThreadPool without locks. Two threads racing on a slot
+* can only make a lookup miss; a hit always returns the score of that board.
+*/
+
+#pragma once
+#include <atomic>
+using namespace std;
+
+class FitnessCache
+{
+public:
+   /*
+   * The constructor allocates room for at least the given number of entries
+   * (rounded up to a power of two). All entries start out empty.
+   */
+   explicit FitnessCache(int entries);
+
+   /*
+   * The destructor deallocates the table.
+   */
+   ~FitnessCache();
+
+   /*
+   * This method looks up hash. If it is in the table, score is set to the
+   * stored fitness and true is returned. Otherwise returns false.
+   */
+   bool lookup(unsigned long long hash, int& score);
+
+   /*
+   * This method stores the fitness score of hash, replacing whatever was in
+   * its slot.
+   */
+   void store(unsigned long long hash, int score);
+
+   /*
+   * These methods return the number of lookups and how many of them hit.
+   */
+   long long getLookups() const;
+   long long getHits() const;
+
+private:
+   /*
+   * This variable is the dynamic array of slots. A slot holds the upper 48
+   * bits of the hash and the score + 1 in the lower 16 bits. A value of 0
+   * marks an empty slot.
+   */
+   atomic<unsigned long long>* entries_;
+
+   /*
+   * This variable is the number of slots minus one, used to turn a hash into
+   * a slot index.
+   */
+   unsigned long long mask_;
+
+   /*
+   * These variables count lookups and hits for reporting.
+   */
+   atomic<long long> lookups_;
+   atomic<long long> hits_;
+};
@@ -3,10 +3,60 @@
 #include "Sudoku.h"
 #include "Fitness.h"
 #include "SudokuFitness.h"
+#include "PermutationFitness.h"
 #include "SudokuPopulation.h"
+#include "Solver.h"
+#include "BatchSolver.h"
+#include "PuzzleCorpus.h"
+#include "Telemetry.h"
+#include "BoardSolver.h"
+#include "Checkpoint.h"
+#include "SolveDaemon.h"
+#include <thread>
+#include <memory>
 
 using namespace std;
 
+/*
+* This helper reads a board with boxes BOX wide from cin (see
+* Board#readPuzzle), solves it with solveBoard and prints the best board.
+* It is used for --size.
+*/
+template <int BOX>
+static int runBoard(const SolverOptions& options) {
+   Board<BOX> board;
+
+   // Settings bigger boards cannot use are reported before reading
+   try {
+      if (BOX != 3) {
+         checkBoardOptions(options);
+      }
+   } catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   cout << "Input a " << Board<BOX>::SIZE << "x" << Board<BOX>::SIZE
+      << " puzzle:";
+   try {
+      cin >> board;
+   } catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   cout << "Processing your puzzle:" << endl;
+   cout << board << endl;
+   cout << "Seed: " << options.seed << endl;
+
+   BoardResult<BOX> result = solveBoard(board, options);
+
+   cout << "Generations: " << result.generations << endl;
+   cout << "Best board: " << endl;
+   cout << result.best << endl;
+   cout << "Best fitness: " << result.fitness << endl;
+   return 0;
+}
 
 int main(int argc, char* argv[]) {
    
@@ -34,6 +84,180 @@ int main(int argc, char* argv[]) {
       return -1;
    }
 
+   // Optional settings
+   SolverOptions options;
+   options.popSize = popSize;
+   options.maxGens = maxGens;
+   // Seed every random stream from the clock unless --seed is given
+   options.seed = (unsigned long long) time(0);
+   bool allocStats = false;
+   string batchFile;
+   string outFile;
+   int jobs = max(1, (int) thread::hardware_concurrency());
+   string telemetryFile;
+   TelemetryFormat telemetryFormat = CSV_TELEMETRY;
+   int telemetryEvery = 10;
+   int boardSize = 0;
+   string serveSocket;
+   int queueCapacity = 0;
+
+   // Parse optional flags after the two numbers
+   for (int i = 3; i < argc; i++) {
+      string flag = argv[i];
+
+      try {
+         if (parseSolverFlag(argc, argv, i, options)) {
+            continue;
+         }
+      }
+      catch (runtime_error& err) {
+         cout << "ERROR: " << err.what() << endl;
+         return -1;
+      }
+
+      if (flag == "--check-delta") {
+         // Verify every delta fitness against a full scan
+         SudokuFitness::getInstance().setCheckMode(true);
+         PermutationFitness::getInstance().setCheckMode(true);
+      } else if (flag == "--alloc-stats") {
+         // Report heap allocations made by the generation loop
+         allocStats = true;
+      } else if ((flag == "--batch" || flag == "--out") && i + 1 < argc) {
+         // Batch input (- for cin) and where batch results go
+         (flag == "--batch" ? batchFile : outFile) = argv[++i];
+      } else if (flag == "--jobs" && i + 1 < argc) {
+         // Number of puzzles solved at the same time (batch and --serve)
+         try {
+            jobs = max(1, stoi(argv[++i]));
+         }
+         catch (exception&) {
+            cout << "ERROR: --jobs needs a number" << endl;
+            return -1;
+         }
+      } else if (flag == "--serve" && i + 1 < argc) {
+         // Run as a daemon on a Unix socket (- for stdin and stdout)
+         serveSocket = argv[++i];
+      } else if (flag == "--queue" && i + 1 < argc) {
+         // Jobs the daemon holds before it stops reading (default 4 per job)
+         try {
+            queueCapacity = max(1, stoi(argv[++i]));
+         }
+         catch (exception&) {
+            cout << "ERROR: --queue needs a number" << endl;
+            return -1;
+         }
+      } else if (flag == "--size" && i + 1 < argc) {
+         // Rows of the board: 9, 16 or 25 (read with Board#readPuzzle)
+         string value = argv[++i];
+         if (value != "9" && value != "16" && value != "25") {
+            cout << "ERROR: --size must be 9, 16 or 25" << endl;
+            return -1;
+         }
+         boardSize = stoi(value);
+      } else if (flag == "--telemetry" && i + 1 < argc) {
+         // File that per-generation records are written to
+         telemetryFile = argv[++i];
+      } else if (flag == "--telemetry-format" && i + 1 < argc) {
+         // csv or jsonl
+         string value = argv[++i];
+         if (value != "csv" && value != "jsonl") {
+            cout << "ERROR: --telemetry-format must be csv or jsonl" << endl;
+            return -1;
+         }
+         telemetryFormat = value == "csv" ? CSV_TELEMETRY : JSONL_TELEMETRY;
+      } else if (flag == "--telemetry-every" && i + 1 < argc) {
+         // Record only every N-th generation (10 by default)
+         try {
+            telemetryEvery = max(1, stoi(argv[++i]));
+         }
+         catch (exception&) {
+            cout << "ERROR: --telemetry-every needs a number" << endl;
+            return -1;
+         }
+      } else {
+         cout << "ERROR: Unknown flag " << flag << endl;
+         return -1;
+      }
+   }
+
+   // Telemetry follows one population, so it needs a single puzzle
+   if (!telemetryFile.empty() && (!batchFile.empty() || options.islands > 0)) {
+      cout << "ERROR: --telemetry cannot be used with --batch or --islands"
+         << endl;
+      return -1;
+   }
+
+   // Checkpoints hold one SudokuPopulation, so they need a single puzzle
+   // solved by the ga engine
+   bool checkpoints = !options.checkpointFile.empty()
+      || !options.resumeFile.empty();
+   if (checkpoints && (!batchFile.empty() || !serveSocket.empty()
+      || options.islands > 0
+      || options.engine != GA_ENGINE || boardSize != 0)) {
+      cout << "ERROR: --checkpoint and --resume cannot be used with --batch,"
+         << " --serve, --islands, --size or another engine" << endl;
+      return -1;
+   }
+
+   // The daemon solves jobs from clients, --jobs at the same time
+   if (!serveSocket.empty()) {
+      if (!batchFile.empty() || boardSize != 0 || !telemetryFile.empty()) {
+         cout << "ERROR: --serve cannot be used with --batch, --size or"
+            << " --telemetry" << endl;
+         return -1;
+      }
+      DaemonOptions daemon;
+      daemon.socketPath = serveSocket;
+      daemon.workers = jobs;
+      daemon.queueCapacity = queueCapacity > 0 ? queueCapacity : 4 * jobs;
+      return runDaemon(daemon, options);
+   }
+
+   // Boards read with --size go through solveBoard (9x9 still uses Sudoku)
+   if (boardSize != 0) {
+      if (!batchFile.empty() || !telemetryFile.empty()) {
+         cout << "ERROR: --size cannot be used with --batch or --telemetry"
+            << endl;
+         return -1;
+      }
+      cout << "Starting genetic algorithm with population of " << popSize
+         << " and max generations of " << maxGens << "." << endl;
+      if (boardSize == 16) {
+         return runBoard<4>(options);
+      } else if (boardSize == 25) {
+         return runBoard<5>(options);
+      }
+      return runBoard<3>(options);
+   }
+
+   // Batch mode solves a whole file of puzzles and skips the prompts
+   if (!batchFile.empty()) {
+      FILE* out = outFile.empty() ? stdout : fopen(outFile.c_str(), "w");
+      if (out == nullptr) {
+         cout << "ERROR: Cannot write " << outFile << endl;
+         return -1;
+      }
+
+      // Files are memory-mapped, - reads the puzzles from cin
+      int status;
+      try {
+         if (batchFile == "-") {
+            status = runBatch(cin, out, options, jobs);
+         } else {
+            PuzzleCorpus corpus(batchFile);
+            status = runBatch(corpus, out, options, jobs);
+         }
+      }
+      catch (runtime_error& err) {
+         cout << "ERROR: " << err.what() << endl;
+         status = -1;
+      }
+
+      if (out != stdout) {
+         fclose(out);
+      }
+      return status;
+   }
 
    Sudoku sudoku;
 
@@ -52,25 +276,105 @@ int main(int argc, char* argv[]) {
    cout << "Processing your sudoku:" << endl;
    cout << sudoku << endl;
 
-   // Use random seed
-   srand(time(0));
-   SudokuPopulation pop(sudoku, popSize);
-   for (int i = 1; i <= maxGens && pop.bestFitness() != 0; i++) {
-      pop.cull(0.9);
-      pop.newGeneration();
+   // Print the seed so the run can be repeated (a resumed run uses the
+   // seed saved in the checkpoint instead)
+   if (options.resumeFile.empty()) {
+      cout << "Seed: " << options.seed << endl;
+   } else {
+      cout << "Resuming from " << options.resumeFile << endl;
+   }
+
+   // Save a checkpoint and stop cleanly when asked to terminate
+   if (!options.checkpointFile.empty()) {
+      watchTermination();
+   }
+
+   // Open the telemetry file if one was given
+   FILE* telemetryOut = nullptr;
+   unique_ptr<Telemetry> telemetry;
+   if (!telemetryFile.empty()) {
+      telemetryOut = fopen(telemetryFile.c_str(), "w");
+      if (telemetryOut == nullptr) {
+         cout << "ERROR: Cannot write " << telemetryFile << endl;
+         return -1;
+      }
+      telemetry.reset(new Telemetry(telemetryOut, telemetryFormat,
+         telemetryEvery));
+      options.telemetry = telemetry.get();
+   }
+
+   SolveResult result;
+   bool failed = false;
+   try {
+      result = solve(sudoku, options);
+   }
+   catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      failed = true;
+   }
+
+   // Flush what was recorded and close the file, even after an error
+   telemetry.reset();
+   if (telemetryOut != nullptr) {
+      fclose(telemetryOut);
+   }
+   if (failed) {
+      return -1;
+   }
+
+   // Report how often boards were seen again
+   PopulationStats stats = result.stats;
+   if (options.cacheEntries > 0) {
+      double rate = stats.cacheLookups > 0
+         ? 100.0 * stats.cacheHits / stats.cacheLookups : 0;
+      cout << "Fitness cache hits: " << stats.cacheHits << " of "
+         << stats.cacheLookups << " lookups (" << rate << "%)" << endl;
+   }
+   if (options.rejectDuplicates) {
+      double rate = stats.offspringCreated > 0
+         ? 100.0 * stats.duplicatesRejected / stats.offspringCreated : 0;
+      cout << "Duplicates rejected: " << stats.duplicatesRejected << " for "
+         << stats.offspringCreated << " offspring (" << rate << "%)" << endl;
+   }
+
+   if (options.adaptive) {
+      cout << "Restarts: " << stats.restarts << endl;
+   }
+   if (options.engine == EXACT_ENGINE) {
+      cout << "Search nodes: " << result.nodes << endl;
+   }
+
+   if (allocStats) {
+      cout << "Allocations during " << result.generations << " generations: "
+         << result.allocations << endl;
+   }
+
+   // Show how the time of the run was spent
+   if (options.timeLimitMs > 0) {
+      if (result.cancelled) {
+         cout << "Time limit reached after " << result.generations
+            << " generations" << endl;
+      }
+      PhaseTimes phases = result.phases;
+      double other = result.totalSeconds - result.setupSeconds
+         - phases.cullSeconds - phases.newGenerationSeconds;
+      cout << "Time used: " << result.totalSeconds * 1000 << " of "
+         << options.timeLimitMs << " ms (setup "
+         << result.setupSeconds * 1000 << ", cull "
+         << phases.cullSeconds * 1000 << ", new generation "
+         << phases.newGenerationSeconds * 1000 << ", other "
+         << max(0.0, other) * 1000 << ")" << endl;
+   }
 
-      /*
-      * For bigger populations, this helps the user understand how much time
-      * is remaining before an output is printed.
-      */
-      //if (i % (maxGens / 10) == 0) {
-      //   cout << "Percent done: " << (100 * i / maxGens) << "%" << endl;
-      //}
+   if (result.interrupted) {
+      cout << "Stopped after " << result.generations << " generations";
+      if (!options.checkpointFile.empty()) {
+         cout << ", saved to " << options.checkpointFile;
+      }
+      cout << endl;
    }
 
    cout << "Best sudoku: " << endl;
-   Puzzle* best = pop.bestIndividual();
-   cout << *best << endl;
-   cout << "Best fitness: " << pop.bestFitness() << endl;
-   //delete best; // Delete so valgrind does not yell at me.
+   cout << result.best << endl;
+   cout << "Best fitness: " << result.fitness << endl;
 }
\ No newline at end of file
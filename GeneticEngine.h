@@ -0,0 +1,245 @@
+/*
+* GeneticEngine.h
+* Timothy Kozlov, Eric Pham
+*
+* This class template is the generation loop of the genetic algorithm with
+* every part picked at compile time: the board type, the factory that
+* fills boards, the fitness class that scores them, the reproduction class
+* that mutates them and the selection strategy. SudokuPopulation reaches
+* the same classes through pointers to their interfaces, so every fill,
+* mutation and score is a virtual call. Here every call names its class
+* (for example fitness_.FitnessT::howFitMask), so it is a direct call that
+* the compiler can inline, and the loop itself has no virtual calls.
+*
+* The engine still implements the Population interface, so code that only
+* knows about Population can drive it; because the class is final, calls
+* made on an engine object directly are bound at compile time as well.
+*
+* Each type must provide these members (the Sudoku and Board classes do):
+*    FactoryT::getInstance(),
+*       fillPuzzleInto(const BoardT&, BoardT&, Random&)
+*    FitnessT::getInstance(), howFitMask(const Puzzle&),
+*       howFitDelta(const Puzzle&, int parentScore)
+*    OffspringT::getInstance(),
+*       makeOffspringInto(const BoardT&, BoardT&, Random&, int percent)
+*    SelectionT::getInstance(), select(...) as in Selection
+*
+* The engine keeps its boards in two vectors that are allocated once. cull
+* only orders the indices, and newGeneration writes the survivors and the
+* offspring of the parents picked by SelectionT (from the whole scored
+* population) into the other vector, then swaps them. It runs on one
+* thread.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Population.h"
+#include "Random.h"
+#include "SudokuOffspring.h"
+
+template <typename BoardT, typename FactoryT, typename FitnessT,
+   typename OffspringT, typename SelectionT>
+class GeneticEngine final : public Population
+{
+public:
+   /*
+   * The constructor fills size boards from original with the factory and
+   * scores them. Every random number comes from a stream derived from
+   * seed.
+   */
+   GeneticEngine(const BoardT& original, int size, unsigned long long seed)
+      : factory_(FactoryT::getInstance()), fitness_(FitnessT::getInstance()),
+      offspring_(OffspringT::getInstance()),
+      selection_(SelectionT::getInstance()), boards_(size), scores_(size),
+      next_(size), order_(size), orderedScores_(size), parents_(size),
+      scratch_(size),
+      survivors_(size), bestIndex_(0), seed_(seed), generation_(0),
+      mutationPercent_(SudokuOffspring::MUTATION_PERCENT) {
+      if (size < 1) {
+         throw runtime_error("A population needs at least one board.");
+      }
+
+      Random rng = Random::stream(seed_, generation_, 1);
+      // Invariant: boards 0 to i - 1 are filled and scored
+      for (int i = 0; i < size; i++) {
+         factory_.FactoryT::fillPuzzleInto(original, boards_[i], rng);
+         scores_[i] = fitness_.FitnessT::howFitMask(boards_[i]);
+         if (scores_[i] < scores_[bestIndex_]) {
+            bestIndex_ = i;
+         }
+         order_[i] = i;
+      }
+   }
+
+   /*
+   * This method is implemented from the Population interface. It puts
+   * the indices of the (size * (1 - percent)) best boards at the front of
+   * order_ with nth_element, like SudokuPopulation#cull. The rest (at
+   * least one) are replaced by newGeneration.
+   */
+   void cull(double percent) {
+      if (percent > 1) {
+         throw runtime_error("Trying to cull more puzzles than there are.");
+      }
+
+      int size = (int) boards_.size();
+      survivors_ = max(0, min(size - 1, int(ceil(size * (1 - percent)))));
+
+      // Ties are broken by index, like SudokuPopulation#cull
+      for (int i = 0; i < size; i++) {
+         order_[i] = i;
+      }
+      const int* scores = scores_.data();
+      nth_element(order_.begin(), order_.begin() + survivors_, order_.end(),
+         [scores](int a, int b) {
+            return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+         });
+
+      // Put the survivors, then the culled boards, back in index order so
+      // newGeneration walks memory forwards (scratch_ marks survivors)
+      for (int k = 0; k < size; k++) {
+         scratch_[order_[k]] = k < survivors_;
+      }
+      int survivor = 0;
+      int culled = survivors_;
+      for (int i = 0; i < size; i++) {
+         order_[scratch_[i] ? survivor++ : culled++] = i;
+      }
+
+      // Selection sees every score in that order, survivors first
+      for (int k = 0; k < size; k++) {
+         orderedScores_[k] = scores_[order_[k]];
+      }
+   }
+
+   /*
+   * This method is implemented from the Population interface. SelectionT
+   * picks a parent from the whole population for every board replaced by
+   * cull, which is replaced with a mutated copy of that parent and scored
+   * from the parent's score.
+   */
+   void newGeneration() {
+      generation_++;
+      int size = (int) boards_.size();
+      int count = size - survivors_;
+
+      // Stream 0 picks parents and stream 1 makes offspring
+      Random selectRng = Random::stream(seed_, generation_, 0);
+      selection_.SelectionT::select(orderedScores_.data(), size, survivors_,
+         count, parents_.data(), scratch_.data(), selectRng);
+
+      // The replaced boards may be parents, so the next generation is
+      // built in next_, starting with the survivors
+      for (int k = 0; k < survivors_; k++) {
+         next_[order_[k]] = boards_[order_[k]];
+      }
+
+      Random rng = Random::stream(seed_, generation_, 1);
+      // Invariant: offspring 0 to k - 1 have been made and scored
+      for (int k = 0; k < count; k++) {
+         int child = order_[survivors_ + k];
+         int parent = order_[parents_[k]];
+         offspring_.OffspringT::makeOffspringInto(boards_[parent],
+            next_[child], rng, mutationPercent_);
+         scores_[child] = fitness_.FitnessT::howFitDelta(next_[child],
+            orderedScores_[parents_[k]]);
+      }
+      swap(boards_, next_);
+      survivors_ = size;
+
+      bestIndex_ = (int) (min_element(scores_.begin(), scores_.end())
+         - scores_.begin());
+   }
+
+   /*
+   * This method is implemented from the Population interface and returns
+   * the best (lowest) fitness score.
+   */
+   int bestFitness() const {
+      return scores_[bestIndex_];
+   }
+
+   /*
+   * This method is implemented from the Population interface. It copies
+   * the board with the best score into best_, which belongs to the engine
+   * and stays valid until the next call or until the population changes.
+   */
+   Puzzle* bestIndividual() const {
+      best_ = boards_[bestIndex_];
+      return &best_;
+   }
+
+   /*
+   * This method returns the board with the best score without copying it.
+   */
+   const BoardT& bestBoard() const {
+      return boards_[bestIndex_];
+   }
+
+   /*
+   * This method sets the mutation rate passed to OffspringT.
+   */
+   void setMutationPercent(int percent) {
+      mutationPercent_ = percent;
+   }
+
+private:
+   /*
+   * The singletons that fill, score, mutate and select.
+   */
+   const FactoryT& factory_;
+   FitnessT& fitness_;
+   const OffspringT& offspring_;
+   const SelectionT& selection_;
+
+   /*
+   * The boards and their fitness scores, and the boards the next
+   * generation is built in.
+   */
+   vector<BoardT> boards_;
+   vector<int> scores_;
+   vector<BoardT> next_;
+
+   /*
+   * Indices into boards_, survivors first after cull.
+   */
+   vector<int> order_;
+
+   /*
+   * Scratch arrays for selection: the scores in order_ order, the parent
+   * picked for each offspring (an index into order_) and the scratch
+   * space that Selection#select may use.
+   */
+   vector<int> orderedScores_;
+   vector<int> parents_;
+   vector<int> scratch_;
+
+   /*
+   * The number of boards that survived the last cull.
+   */
+   int survivors_;
+
+   /*
+   * The index of the board with the lowest score.
+   */
+   int bestIndex_;
+
+   /*
+   * The seed every random stream comes from and the generation counter.
+   */
+   unsigned long long seed_;
+   long long generation_;
+
+   /*
+   * The mutation rate passed to OffspringT.
+   */
+   int mutationPercent_;
+
+   /*
+   * The copy of the best board returned by bestIndividual.
+   */
+   mutable BoardT best_;
+};
@@ -0,0 +1,228 @@
+/*
+* IslandModel.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class runs the genetic algorithm as several independent islands.
+* Each island is its own SudokuPopulation with its own random stream and
+* runs on its own thread. Every few generations, each island sends copies
+* of its best puzzles to the next island in a ring, which replace that
+* island's worst puzzles. This keeps the islands from all getting stuck on
+* the same local minimum. As soon as any island finds a solution (fitness
+* zero), or the run's cancellation token is cancelled, every island stops.
+*
+* Migrants go through a mailbox between each pair of neighbours. A mailbox
+* has exactly one sender and one receiver and only uses two atomic
+* counters, so islands never take a lock. Islands wait for their neighbour
+* at each migration, so a run that does not stop early is reproducible for
+* the same seed.
+*/
+
+#include "IslandModel.h"
+#include "Random.h"
+#include "AdaptiveController.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*
+* The constructor builds one population per island from original. Each
+* population gets its own seed derived from options.seed.
+*/
+IslandModel::IslandModel(const Sudoku& original,
+   const IslandOptions& options) : options_(options), solved_(false) {
+   if (options.islands < 1) {
+      throw runtime_error("Island mode needs at least one island");
+   }
+   if (options.migrationInterval < 1) {
+      throw runtime_error("Migration interval must be at least 1");
+   }
+
+   int islands = options.islands;
+   islands_.resize(islands);
+   mailboxes_ = new Mailbox[islands];
+   generations_ = new int[islands];
+
+   for (int i = 0; i < islands; i++) {
+      // Every island gets its own seed from the run seed
+      unsigned long long seed = Random::stream(options.seed, i).next();
+      islands_[i].reset(new SudokuPopulation(original, options.popSize,
+         seed, options.arena, options.encoding));
+      islands_[i]->setFitnessCache(options.cacheEntries);
+      islands_[i]->setRejectDuplicates(options.rejectDuplicates);
+      islands_[i]->setCrossover(options.crossover);
+      islands_[i]->setSelection(options.selection);
+      islands_[i]->setMutationPercent(options.mutationPercent);
+
+      // Room for the migrants sent to this island
+      mailboxes_[i].boards = new Sudoku[options.migrants > 0
+         ? options.migrants : 1];
+      mailboxes_[i].count = 0;
+      mailboxes_[i].sent.store(0);
+      mailboxes_[i].taken.store(0);
+      generations_[i] = 0;
+   }
+}
+
+/*
+* The destructor deallocates the mailboxes (the islands are freed by
+* islands_).
+*/
+IslandModel::~IslandModel() {
+   for (int i = 0; i < options_.islands; i++) {
+      delete[] mailboxes_[i].boards;
+   }
+
+   delete[] mailboxes_;
+   delete[] generations_;
+}
+
+/*
+* This method runs every island on its own thread until they reach
+* maxGens or one of them finds a solution.
+*/
+void IslandModel::run() {
+   vector<thread> threads;
+
+   // Island 0 runs on the calling thread
+   for (int i = 1; i < options_.islands; i++) {
+      threads.push_back(thread(&IslandModel::runIsland, this, i));
+   }
+   runIsland(0);
+
+   for (thread& t : threads) {
+      t.join();
+   }
+}
+
+/*
+* This method returns the best fitness score over all islands.
+*/
+int IslandModel::bestFitness() const {
+   int best = islands_[0]->bestFitness();
+   for (int i = 1; i < options_.islands; i++) {
+      best = min(best, islands_[i]->bestFitness());
+   }
+   return best;
+}
+
+/*
+* This method returns the best puzzle over all islands. The puzzle still
+* belongs to its island.
+*/
+Puzzle* IslandModel::bestIndividual() const {
+   int best = 0;
+   for (int i = 1; i < options_.islands; i++) {
+      if (islands_[i]->bestFitness() < islands_[best]->bestFitness()) {
+         best = i;
+      }
+   }
+   return islands_[best]->bestIndividual();
+}
+
+/*
+* This method returns the largest number of generations any island ran.
+*/
+int IslandModel::generations() const {
+   int most = 0;
+   for (int i = 0; i < options_.islands; i++) {
+      most = max(most, generations_[i]);
+   }
+   return most;
+}
+
+/*
+* This method returns the cache and duplicate counters of every island
+* added together.
+*/
+PopulationStats IslandModel::getStats() const {
+   PopulationStats total;
+   for (int i = 0; i < options_.islands; i++) {
+      PopulationStats stats = islands_[i]->getStats();
+      total.offspringCreated += stats.offspringCreated;
+      total.duplicatesRejected += stats.duplicatesRejected;
+      total.cacheLookups += stats.cacheLookups;
+      total.cacheHits += stats.cacheHits;
+      total.restarts += stats.restarts;
+   }
+   return total;
+}
+
+/*
+* This method is the body of the thread running island index.
+*/
+void IslandModel::runIsland(int index) {
+   SudokuPopulation& pop = *islands_[index];
+   Mailbox& outbox = mailboxes_[(index + 1) % options_.islands];
+   Mailbox& inbox = mailboxes_[index];
+   long long migrations = 0;
+
+   // Steer the mutation rate and restarts of this island if asked to
+   AdaptiveOptions adaptiveOptions;
+   adaptiveOptions.restartAfter = options_.restartAfter;
+   AdaptiveController controller(pop, adaptiveOptions);
+
+   for (int gen = 1; gen <= options_.maxGens; gen++) {
+      // Stop as soon as any island has a solution or the run is cancelled
+      if (solved_.load(memory_order_relaxed) || cancelled()) {
+         break;
+      }
+      if (pop.bestFitness() == 0) {
+         solved_.store(true);
+         break;
+      }
+
+      pop.cull(options_.cullPercent);
+      pop.newGeneration();
+      if (options_.adaptive) {
+         controller.update();
+      }
+      generations_[index] = gen;
+
+      // Exchange migrants around the ring every migrationInterval
+      bool migrate = options_.islands > 1 && options_.migrants > 0
+         && gen % options_.migrationInterval == 0;
+      if (migrate) {
+         migrations++;
+
+         // Wait until the next island took the last batch, then send
+         if (!waitFor(outbox.taken, migrations - 1)) {
+            break;
+         }
+         outbox.count = pop.copyBest(options_.migrants, outbox.boards);
+         outbox.sent.store(migrations, memory_order_release);
+
+         // Wait for the batch from the previous island, then take it in
+         if (!waitFor(inbox.sent, migrations)) {
+            break;
+         }
+         pop.replaceWorst(inbox.boards, inbox.count);
+         inbox.taken.store(migrations, memory_order_release);
+      }
+   }
+
+   // Make sure the other islands stop if this one was solved
+   if (pop.bestFitness() == 0) {
+      solved_.store(true);
+   }
+}
+
+/*
+* This helper waits until counter reaches value, giving up early if the
+* run is stopping. Returns false if it gave up.
+*/
+bool IslandModel::waitFor(const atomic<long long>& counter, long long value) {
+   while (counter.load(memory_order_acquire) < value) {
+      if (solved_.load(memory_order_relaxed) || cancelled()) {
+         return false;
+      }
+      this_thread::yield();
+   }
+   return true;
+}
+
+/*
+* This helper returns true if the run's cancellation token was cancelled.
+*/
+bool IslandModel::cancelled() const {
+   return options_.cancel != nullptr && options_.cancel->isCancelled();
+}
@@ -0,0 +1,150 @@
+/*
+* IslandModel.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class runs the genetic algorithm as several independent islands.
+* Each island is its own SudokuPopulation with its own random stream and
+* runs on its own thread. Every few generations, each island sends copies
+* of its best puzzles to the next island in a ring, which replace that
+* island's worst puzzles. This keeps the islands from all getting stuck on
+* the same local minimum. As soon as any island finds a solution (fitness
+* zero), or the run's cancellation token is cancelled, every island stops.
+*
+* Migrants go through a mailbox between each pair of neighbours. A mailbox
+* has exactly one sender and one receiver and only uses two atomic
+* counters, so islands never take a lock. Islands wait for their neighbour
+* at each migration, so a run that does not stop early is reproducible for
+* the same seed.
+*/
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "CancellationToken.h"
+#include "Sudoku.h"
+#include "SudokuPopulation.h"
+#include "SudokuOffspring.h"
+
+/*
+* This struct holds the settings of an island run.
+*/
+struct IslandOptions {
+   int islands = 4;              // number of islands (and threads)
+   int popSize = 1000;           // puzzles per island
+   int maxGens = 1000;           // generations per island
+   int migrationInterval = 50;   // generations between migrations
+   int migrants = 5;             // puzzles sent at each migration
+   double cullPercent = 0.9;     // passed to SudokuPopulation#cull
+   bool arena = false;           // arena storage for every island
+   int cacheEntries = 0;         // fitness cache size per island
+   bool rejectDuplicates = false; // remake duplicate offspring
+   unsigned long long seed = 0;  // seed that island streams come from
+   Encoding encoding = CELL_ENCODING; // how boards are filled and mutated
+   Crossover crossover = NO_CROSSOVER; // how parents are combined
+   SelectionKind selection = TRUNCATION_SELECTION; // how parents are picked
+   int mutationPercent = SudokuOffspring::MUTATION_PERCENT; // starting rate
+   bool adaptive = false;        // adaptive mutation rate and restarts
+   int restartAfter = 200;       // stagnant generations before a restart
+   const CancellationToken* cancel = nullptr; // stops every island when
+                                 // cancelled, nullptr for none
+};
+
+class IslandModel
+{
+public:
+   /*
+   * The constructor builds one population per island from original. Each
+   * population gets its own seed derived from options.seed.
+   */
+   IslandModel(const Sudoku& original, const IslandOptions& options);
+
+   /*
+   * The destructor deallocates the mailboxes (the islands are freed by
+   * islands_).
+   */
+   ~IslandModel();
+
+   /*
+   * This method runs every island on its own thread until they reach
+   * maxGens or one of them finds a solution.
+   */
+   void run();
+
+   /*
+   * This method returns the best fitness score over all islands.
+   */
+   int bestFitness() const;
+
+   /*
+   * This method returns the best puzzle over all islands. The puzzle still
+   * belongs to its island.
+   */
+   Puzzle* bestIndividual() const;
+
+   /*
+   * This method returns the largest number of generations any island ran.
+   */
+   int generations() const;
+
+   /*
+   * This method returns the cache and duplicate counters of every island
+   * added together.
+   */
+   PopulationStats getStats() const;
+
+private:
+   /*
+   * This struct carries migrants from one island to the next. sent counts
+   * the migrations written by the sender and taken counts the ones read by
+   * the receiver, so the sender never overwrites migrants that have not
+   * been read yet.
+   */
+   struct Mailbox {
+      Sudoku* boards;
+      int count;
+      atomic<long long> sent;
+      atomic<long long> taken;
+   };
+
+   /*
+   * This method is the body of the thread running island index.
+   */
+   void runIsland(int index);
+
+   /*
+   * This helper waits until counter reaches value, giving up early if the
+   * run is stopping. Returns false if it gave up.
+   */
+   bool waitFor(const atomic<long long>& counter, long long value);
+
+   /*
+   * This helper returns true if the run's cancellation token was cancelled.
+   */
+   bool cancelled() const;
+
+   /*
+   * The settings of the run.
+   */
+   IslandOptions options_;
+
+   /*
+   * The populations, one per island.
+   */
+   vector<unique_ptr<SudokuPopulation>> islands_;
+
+   /*
+   * The mailboxes. Mailbox i carries migrants into island i.
+   */
+   Mailbox* mailboxes_;
+
+   /*
+   * The number of generations each island ran.
+   */
+   int* generations_;
+
+   /*
+   * This flag is raised by the first island to find a solution.
+   */
+   atomic<bool> solved_;
+};
@@ -0,0 +1,103 @@
+/*
+* PermutationFactory.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is the PuzzleFactory for the permutation encoding. It fills
+* each 3x3 box with a random permutation of the digits that box is missing,
+* so a new board never has a box conflict, and it makes offspring with
+* PermutationOffspring (a swap inside one box) so that this stays true.
+* Boards made this way are scored with PermutationFitness.
+*/
+
+#include "PermutationFactory.h"
+#include "PermutationOffspring.h"
+#include "SudokuTables.h"
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+PermutationFactory& PermutationFactory::getInstance() {
+   // Create a static instance
+   static PermutationFactory instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method copies unsolved into out and fills the free cells of every
+* box with a random permutation of the digits the box is missing.
+*/
+void PermutationFactory::fillPuzzleInto(const Sudoku& unsolved, Sudoku& out,
+   Random& rng) const {
+   // Copy the puzzle (skipped if they are the same puzzle)
+   if (&unsolved != &out) {
+      out = unsolved;
+   }
+
+   // Invariant: 0 <= box < 9
+   for (int box = 0; box < 9; box++) {
+      const unsigned char* cells = SUDOKU_TABLES.unitCells[18 + box];
+
+      // Find the free cells and the digits the fixed cells already use
+      int free[9];
+      int count = 0;
+      bool used[10] = { false };
+      // Invariant: 0 <= i < 9
+      for (int i = 0; i < 9; i++) {
+         int row = cells[i] / 9;
+         int col = cells[i] % 9;
+         if (out.isFixed(row, col)) {
+            used[out.getDigitAt(row, col)] = true;
+         } else {
+            free[count] = cells[i];
+            count++;
+         }
+      }
+
+      // The digits the box is missing (at least count of them)
+      int missing[9];
+      int missingCount = 0;
+      // Invariant: 1 <= digit <= 9
+      for (int digit = 1; digit <= 9; digit++) {
+         if (!used[digit]) {
+            missing[missingCount] = digit;
+            missingCount++;
+         }
+      }
+
+      // Shuffle them (Fisher-Yates) and hand them out to the free cells
+      // Invariant: the digits after i are already shuffled
+      for (int i = missingCount - 1; i > 0; i--) {
+         swap(missing[i], missing[rng.nextInt(i + 1)]);
+      }
+      // Invariant: 0 <= i < count
+      for (int i = 0; i < count; i++) {
+         out.setDigitAt(free[i] / 9, free[i] % 9, missing[i]);
+      }
+   }
+}
+
+/*
+* This method copies solved into out and swaps two free cells inside one
+* box using PermutationOffspring.
+*/
+void PermutationFactory::createPuzzleInto(const Sudoku& solved, Sudoku& out,
+   Random& rng, int mutationPercent) const {
+   PermutationOffspring::getInstance().makeOffspringInto(solved, out, rng,
+      mutationPercent);
+}
+
+/*
+* This method writes a box crossover of mother and father into out and
+* then swaps two cells inside one box, so every box stays a permutation.
+*/
+void PermutationFactory::crossPuzzleInto(const Sudoku& mother,
+   const Sudoku& father, Sudoku& out, Crossover kind, Random& rng,
+   int mutationPercent) const {
+   PermutationOffspring& repro = PermutationOffspring::getInstance();
+
+   // Combine the parents, then mutate the child in place
+   repro.crossoverInto(mother, father, out, kind, rng);
+   repro.makeOffspringInto(out, out, rng, mutationPercent);
+}
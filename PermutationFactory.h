@@ -0,0 +1,43 @@
+/*
+* PermutationFactory.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is the PuzzleFactory for the permutation encoding. It fills
+* each 3x3 box with a random permutation of the digits that box is missing,
+* so a new board never has a box conflict, and it makes offspring with
+* PermutationOffspring (a swap inside one box) so that this stays true.
+* Boards made this way are scored with PermutationFitness.
+*/
+
+#pragma once
+#include "SudokuFactory.h"
+
+class PermutationFactory : public SudokuFactory
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static PermutationFactory& getInstance();
+
+   /*
+   * This method copies unsolved into out and fills the free cells of every
+   * box with a random permutation of the digits the box is missing.
+   */
+   void fillPuzzleInto(const Sudoku& unsolved, Sudoku& out,
+      Random& rng) const;
+
+   /*
+   * This method copies solved into out and swaps two free cells inside one
+   * box using PermutationOffspring.
+   */
+   void createPuzzleInto(const Sudoku& solved, Sudoku& out,
+      Random& rng, int mutationPercent) const;
+
+   /*
+   * This method writes a box crossover of mother and father into out and
+   * then swaps two cells inside one box, so every box stays a permutation.
+   */
+   void crossPuzzleInto(const Sudoku& mother, const Sudoku& father,
+      Sudoku& out, Crossover kind, Random& rng, int mutationPercent) const;
+};
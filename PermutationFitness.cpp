@@ -0,0 +1,62 @@
+/*
+* PermutationFitness.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class scores boards of the permutation encoding (see
+* PermutationFactory). Every box of such a board already holds each digit
+* once, so only the 9 rows and 9 columns are checked. On those boards the
+* score is the same as SudokuFitness gives, which is why the delta scoring
+* of SudokuFitness#howFitDelta still works unchanged.
+*/
+
+#include "PermutationFitness.h"
+#include "Sudoku.h"
+#include "SudokuTables.h"
+#include <bitset>
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+PermutationFitness& PermutationFitness::getInstance() {
+   // Create a static instance
+   static PermutationFitness instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method is an implementation from the Fitness interface. It
+* returns the number of repeated digits in the rows and columns of the
+* sudoku.
+*/
+int PermutationFitness::howFit(const Puzzle& puzzle) {
+   return howFitMask(puzzle);
+}
+
+/*
+* This method returns the same score as howFit. It exists so the
+* population can call either fitness class the same way.
+*/
+int PermutationFitness::howFitMask(const Puzzle& puzzle) const {
+   const int* cells = ((const Sudoku*) &puzzle)->getCells();
+   int issues = 0;
+
+   // Only rows (units 0-8) and columns (units 9-17) can have repeats
+   // Invariant: 0 <= unit < 18
+   for (int unit = 0; unit < 18; unit++) {
+      const unsigned char* unitCells = SUDOKU_TABLES.unitCells[unit];
+
+      // Set one bit per distinct digit in the unit
+      unsigned short mask = 0;
+      // Invariant: 0 <= i < 9
+      for (int i = 0; i < 9; i++) {
+         mask |= (unsigned short)(1 << cells[unitCells[i]]);
+      }
+
+      // Every cell that did not add a new bit is a repeat
+      issues += 9 - (int) bitset<16>(mask).count();
+   }
+
+   return issues;
+}
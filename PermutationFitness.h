@@ -0,0 +1,35 @@
+/*
+* PermutationFitness.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class scores boards of the permutation encoding (see
+* PermutationFactory). Every box of such a board already holds each digit
+* once, so only the 9 rows and 9 columns are checked. On those boards the
+* score is the same as SudokuFitness gives, which is why the delta scoring
+* of SudokuFitness#howFitDelta still works unchanged.
+*/
+
+#pragma once
+#include "SudokuFitness.h"
+
+class PermutationFitness : public SudokuFitness
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static PermutationFitness& getInstance();
+
+   /*
+   * This method is an implementation from the Fitness interface. It
+   * returns the number of repeated digits in the rows and columns of the
+   * sudoku.
+   */
+   int howFit(const Puzzle& puzzle);
+
+   /*
+   * This method returns the same score as howFit. It exists so the
+   * population can call either fitness class the same way.
+   */
+   int howFitMask(const Puzzle& puzzle) const;
+};
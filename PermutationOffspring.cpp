@@ -0,0 +1,131 @@
+/*
+* PermutationOffspring.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Reproduction interface for the permutation
+* encoding. Boards made by PermutationFactory hold every digit 1-9 exactly
+* once in each 3x3 box. Instead of overwriting cells with random digits, an
+* offspring swaps two cells that are not fixed inside one box, so every
+* box stays a permutation and only row and column conflicts can change.
+*/
+
+#include "PermutationOffspring.h"
+#include "SudokuOffspring.h"
+#include "SudokuTables.h"
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+PermutationOffspring& PermutationOffspring::getInstance() {
+   // Create a static instance
+   static PermutationOffspring instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method accepts a Puzzle object, casts it to a Sudoku, clones it
+* and swaps two cells inside one box of the clone using rng. Then, it
+* returns the cloned object.
+*/
+Puzzle* PermutationOffspring::makeOffspring(const Puzzle& puzzle,
+   Random& rng) const {
+   // Cast puzzle to a sudoku and clone it
+   Sudoku* copy = new Sudoku(*(const Sudoku*) &puzzle);
+
+   // Mutate the clone in place
+   makeOffspringInto(*copy, *copy, rng);
+
+   return copy;
+}
+
+/*
+* This method does the same thing as makeOffspring, except that it copies
+* parent into a puzzle that already exists instead of allocating a new
+* one. After the first swap, another swap is made each time a random
+* number from 0-99 is below mutationPercent, so a higher rate means
+* more swaps.
+*/
+void PermutationOffspring::makeOffspringInto(const Sudoku& parent,
+   Sudoku& child, Random& rng, int mutationPercent) const {
+   // Copy the parent into the child (skipped if they are the same puzzle)
+   if (&parent != &child) {
+      child = parent;
+   }
+
+   // Invariant: every swap so far kept each box a permutation
+   while (swapInBox(child, rng) && rng.nextInt(100) < mutationPercent) {
+   }
+}
+
+/*
+* This helper swaps two free cells inside one random box of child.
+* Returns false if no box has two free cells.
+*/
+bool PermutationOffspring::swapInBox(Sudoku& child, Random& rng) {
+   // Start at a random box and use the first one with two free cells. A
+   // board with no such box has nothing to swap.
+   int first = rng.nextInt(9);
+   // Invariant: 0 <= i < 9
+   for (int i = 0; i < 9; i++) {
+      int box = (first + i) % 9;
+      const unsigned char* cells = SUDOKU_TABLES.unitCells[18 + box];
+
+      // Collect the cells of the box that can be changed
+      int free[9];
+      int count = 0;
+      // Invariant: 0 <= j < 9
+      for (int j = 0; j < 9; j++) {
+         if (!child.isFixed(cells[j] / 9, cells[j] % 9)) {
+            free[count] = cells[j];
+            count++;
+         }
+      }
+      if (count < 2) {
+         continue;
+      }
+
+      // Pick two different free cells and swap their digits
+      int a = free[rng.nextInt(count)];
+      int b = free[rng.nextInt(count - 1)];
+      if (b == a) {
+         b = free[count - 1];
+      }
+
+      int digitA = child.getDigitAt(a / 9, a % 9);
+      int digitB = child.getDigitAt(b / 9, b % 9);
+      child.setDigitAt(a / 9, a % 9, digitB);
+      child.setDigitAt(b / 9, b % 9, digitA);
+      return true;
+   }
+
+   return false;
+}
+
+/*
+* This method is implemented from the Reproduction interface. It clones
+* mother and copies whole boxes over from father, each with a 50% chance
+* drawn from rng. Only box crossover keeps every box a permutation, so
+* ROW_CROSSOVER and UNIFORM_CROSSOVER are treated as BOX_CROSSOVER.
+*/
+Puzzle* PermutationOffspring::crossover(const Puzzle& mother,
+   const Puzzle& father, Crossover kind, Random& rng) const {
+   // Build the child in place in a clone of mother
+   Sudoku* child = new Sudoku(*(const Sudoku*) &mother);
+   crossoverInto(*child, *(const Sudoku*) &father, *child, kind, rng);
+
+   return child;
+}
+
+/*
+* This method does the same thing as crossover, but writes the child into
+* a puzzle that already exists. The child's fitness delta is relative to
+* mother, so it can be scored from mother's score.
+*/
+void PermutationOffspring::crossoverInto(const Sudoku& mother,
+   const Sudoku& father, Sudoku& child, Crossover kind, Random& rng) const {
+   // Any crossover other than none is done box by box
+   SudokuOffspring::getInstance().crossoverInto(mother, father, child,
+      kind == NO_CROSSOVER ? NO_CROSSOVER : BOX_CROSSOVER, rng);
+}
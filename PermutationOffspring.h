@@ -0,0 +1,65 @@
+/*
+* PermutationOffspring.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Reproduction interface for the permutation
+* encoding. Boards made by PermutationFactory hold every digit 1-9 exactly
+* once in each 3x3 box. Instead of overwriting cells with random digits, an
+* offspring swaps two cells that are not fixed inside one box, so every
+* box stays a permutation and only row and column conflicts can change.
+*/
+
+#pragma once
+#include "Reproduction.h"
+#include "Sudoku.h"
+#include "SudokuOffspring.h"
+
+class PermutationOffspring : public Reproduction
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static PermutationOffspring& getInstance();
+
+   /*
+   * This method accepts a Puzzle object, casts it to a Sudoku, clones it
+   * and swaps two cells inside one box of the clone using rng. Then, it
+   * returns the cloned object.
+   */
+   Puzzle* makeOffspring(const Puzzle& puzzle, Random& rng) const;
+
+   /*
+   * This method does the same thing as makeOffspring, except that it copies
+   * parent into a puzzle that already exists instead of allocating a new
+   * one. After the first swap, another swap is made each time a random
+   * number from 0-99 is below mutationPercent, so a higher rate means
+   * more swaps.
+   */
+   void makeOffspringInto(const Sudoku& parent, Sudoku& child, Random& rng,
+      int mutationPercent = SudokuOffspring::MUTATION_PERCENT) const;
+
+   /*
+   * This method is implemented from the Reproduction interface. It clones
+   * mother and copies whole boxes over from father, each with a 50% chance
+   * drawn from rng. Only box crossover keeps every box a permutation, so
+   * ROW_CROSSOVER and UNIFORM_CROSSOVER are treated as BOX_CROSSOVER.
+   */
+   Puzzle* crossover(const Puzzle& mother, const Puzzle& father,
+      Crossover kind, Random& rng) const;
+
+   /*
+   * This method does the same thing as crossover, but writes the child into
+   * a puzzle that already exists. The child's fitness delta is relative to
+   * mother, so it can be scored from mother's score.
+   */
+   void crossoverInto(const Sudoku& mother, const Sudoku& father,
+      Sudoku& child, Crossover kind, Random& rng) const;
+
+private:
+   /*
+   * This helper swaps two free cells inside one random box of child.
+   * Returns false if no box has two free cells.
+   */
+   static bool swapInBox(Sudoku& child, Random& rng);
+};
@@ -0,0 +1,164 @@
+/*
+* PuzzleCorpus.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class reads a corpus of sudoku puzzles from a file, one puzzle per
+* line. The file is memory-mapped and every board is parsed straight from
+* the mapped bytes into a Sudoku, so no string is made for any line. This
+* keeps multi-GB puzzle dumps fast to read.
+*
+* Each puzzle is 81 cells in row-major order. A cell is a digit 1-9 or a
+* blank written as '0' or '.'. Anything after the 81st cell that is
+* separated by a space, tab, ',' or ';' is ignored (so "puzzle,solution"
+* files work). Blank lines and lines starting with '#' are skipped. Any
+* other line is malformed; it is reported to cerr with its line number and
+* byte offset and then skipped.
+*/
+
+#include "PuzzleCorpus.h"
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+* This constructor opens and maps the file at path. Throws a
+* runtime_error if the file cannot be opened or mapped.
+*/
+PuzzleCorpus::PuzzleCorpus(const string& path)
+   : fd_(-1), data_(nullptr), size_(0), pos_(0), line_(1), malformed_(0) {
+   fd_ = open(path.c_str(), O_RDONLY);
+   if (fd_ < 0) {
+      throw runtime_error("Cannot open puzzle corpus " + path);
+   }
+
+   struct stat info;
+   if (fstat(fd_, &info) != 0) {
+      close(fd_);
+      throw runtime_error("Cannot read size of puzzle corpus " + path);
+   }
+   size_ = (size_t) info.st_size;
+
+   // An empty file cannot be mapped, but it is just an empty corpus
+   if (size_ > 0) {
+      void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (map == MAP_FAILED) {
+         close(fd_);
+         throw runtime_error("Cannot map puzzle corpus " + path);
+      }
+
+      // The file is read front to back exactly once
+      madvise(map, size_, MADV_SEQUENTIAL);
+      data_ = (const char*) map;
+   }
+}
+
+/*
+* The destructor unmaps and closes the file.
+*/
+PuzzleCorpus::~PuzzleCorpus() {
+   if (data_ != nullptr) {
+      munmap((void*) data_, size_);
+   }
+   close(fd_);
+}
+
+/*
+* This method parses the next puzzle in the file into sudoku and sets
+* lineNumber to the (1-based) line it came from. Comment, blank and
+* malformed lines are skipped. Returns false once the end of the file is
+* reached.
+*/
+bool PuzzleCorpus::next(Sudoku& sudoku, long long& lineNumber) {
+   // Invariant: pos_ is the offset of the start of line line_
+   while (pos_ < size_) {
+      const char* begin = data_ + pos_;
+      const char* newline =
+         (const char*) memchr(begin, '\n', size_ - pos_);
+      const char* end = newline != nullptr ? newline : data_ + size_;
+
+      size_t lineStart = pos_;
+      long long line = line_;
+      pos_ = (size_t)(end - data_) + 1;
+      line_++;
+
+      // Skip leading whitespace to spot blank and comment lines
+      const char* first = begin;
+      while (first < end && (*first == ' ' || *first == '\t' ||
+         *first == '\r')) {
+         first++;
+      }
+      if (first == end || *first == '#') {
+         continue;
+      }
+
+      long long bad = parseLine(first, end, sudoku);
+      if (bad < 0) {
+         lineNumber = line;
+         return true;
+      }
+
+      malformed_++;
+      cerr << "ERROR: Malformed puzzle on line " << line << " (byte offset "
+         << lineStart << ", column " << (first - begin) + bad + 1 << ")"
+         << endl;
+   }
+
+   return false;
+}
+
+/*
+* This helper parses the line that starts at begin and ends at end (the
+* newline or the end of the file) into sudoku. Returns the offset of the
+* first bad character from begin, or -1 if the line is a good puzzle.
+* BatchSolver and SolveDaemon use it too, so every reader accepts the
+* same format.
+*/
+long long PuzzleCorpus::parseLine(const char* begin, const char* end,
+   Sudoku& sudoku) {
+   unsigned char cells[81];
+
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      // The line ended too soon
+      if (begin + cell >= end) {
+         return cell;
+      }
+
+      char c = begin[cell];
+      if (c >= '0' && c <= '9') {
+         cells[cell] = (unsigned char)(c - '0');
+      } else if (c == '.') {
+         cells[cell] = 0;
+      } else {
+         return cell;
+      }
+   }
+
+   // Only a separator (or the end of the line) may follow the board
+   if (begin + 81 < end) {
+      char c = begin[81];
+      if (c != ' ' && c != '\t' && c != '\r' && c != ',' && c != ';') {
+         return 81;
+      }
+   }
+
+   sudoku.loadCells(cells);
+   return -1;
+}
+
+/*
+* This method returns how many malformed lines have been skipped so far.
+*/
+long long PuzzleCorpus::getMalformed() const {
+   return malformed_;
+}
+
+/*
+* This method returns the size of the mapped file in bytes.
+*/
+size_t PuzzleCorpus::size() const {
+   return size_;
+}
@@ -0,0 +1,102 @@
+/*
+* PuzzleCorpus.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class reads a corpus of sudoku puzzles from a file, one puzzle per
+* line. The file is memory-mapped and every board is parsed straight from
+* the mapped bytes into a Sudoku, so no string is made for any line. This
+* keeps multi-GB puzzle dumps fast to read.
+*
+* Each puzzle is 81 cells in row-major order. A cell is a digit 1-9 or a
+* blank written as '0' or '.'. Anything after the 81st cell that is
+* separated by a space, tab, ',' or ';' is ignored (so "puzzle,solution"
+* files work). Blank lines and lines starting with '#' are skipped. Any
+* other line is malformed; it is reported to cerr with its line number and
+* byte offset and then skipped.
+*/
+
+#pragma once
+#include <string>
+#include "Sudoku.h"
+
+class PuzzleCorpus
+{
+public:
+   /*
+   * This constructor opens and maps the file at path. Throws a
+   * runtime_error if the file cannot be opened or mapped.
+   */
+   explicit PuzzleCorpus(const string& path);
+
+   /*
+   * The destructor unmaps and closes the file.
+   */
+   ~PuzzleCorpus();
+
+   /*
+   * The mapping is owned by the corpus, so it cannot be copied.
+   */
+   PuzzleCorpus(const PuzzleCorpus& other) = delete;
+   PuzzleCorpus& operator=(const PuzzleCorpus& other) = delete;
+
+   /*
+   * This method parses the next puzzle in the file into sudoku and sets
+   * lineNumber to the (1-based) line it came from. Comment, blank and
+   * malformed lines are skipped. Returns false once the end of the file is
+   * reached.
+   */
+   bool next(Sudoku& sudoku, long long& lineNumber);
+
+   /*
+   * This method returns how many malformed lines have been skipped so far.
+   */
+   long long getMalformed() const;
+
+   /*
+   * This helper parses the line that starts at begin and ends at end (the
+   * newline or the end of the file) into sudoku. Returns the offset of the
+   * first bad character from begin, or -1 if the line is a good puzzle.
+   * BatchSolver and SolveDaemon use it too, so every reader accepts the
+   * same format.
+   */
+   static long long parseLine(const char* begin, const char* end,
+      Sudoku& sudoku);
+
+   /*
+   * This method returns the size of the mapped file in bytes.
+   */
+   size_t size() const;
+
+private:
+
+   /*
+   * This variable holds the file descriptor of the mapped file.
+   */
+   int fd_;
+
+   /*
+   * This variable points at the first byte of the mapping (nullptr for an
+   * empty file).
+   */
+   const char* data_;
+
+   /*
+   * This variable holds the size of the mapping in bytes.
+   */
+   size_t size_;
+
+   /*
+   * This variable holds the offset of the next line to read.
+   */
+   size_t pos_;
+
+   /*
+   * This variable holds the number of the next line to read (1-based).
+   */
+   long long line_;
+
+   /*
+   * This variable counts the malformed lines that were skipped.
+   */
+   long long malformed_;
+};
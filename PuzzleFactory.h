@@ -7,17 +7,19 @@
 */
 #pragma once
 #include "Puzzle.h"
+#include "Random.h"
 
 class PuzzleFactory {
 public:
    /*
-   * This pure virtual method accepts an unsolved puzzle and then randomly solves it.
+   * This pure virtual method accepts an unsolved puzzle and then randomly solves it
+   * using numbers drawn from rng.
    */
-   virtual Puzzle* fillPuzzle(const Puzzle& unsolved) const = 0;
+   virtual Puzzle* fillPuzzle(const Puzzle& unsolved, Random& rng) const = 0;
 
    /*
    * This pure virtual method accepts a puzzle that has been solved already and then
    * uses the Reproduction#makeOffspring method to return a new, mutated puzzle.
    */
-   virtual Puzzle* createPuzzle(const Puzzle& solved) const = 0;
+   virtual Puzzle* createPuzzle(const Puzzle& solved, Random& rng) const = 0;
 };
\ No newline at end of file
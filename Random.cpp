@@ -0,0 +1,51 @@
+/*
+* Random.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is a small, fast random number generator (xoshiro256**) that
+* replaces the global rand(). Every Random object has its own 256-bit state,
+* so each thread, chunk or island can have its own stream and runs with the
+* same seed are reproducible. nextInt returns numbers without the modulo
+* bias of rand() % n.
+*/
+
+#include "Random.h"
+
+/*
+* This helper advances a splitmix64 state and returns its next output. It
+* is only used to turn seeds into generator states.
+*/
+static unsigned long long splitmix64(unsigned long long& state) {
+   state += 0x9E3779B97F4A7C15ULL;
+   unsigned long long z = state;
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+   return z ^ (z >> 31);
+}
+
+/*
+* The constructor expands a 64-bit seed into the full state using
+* splitmix64, so nearby seeds still give unrelated streams.
+*/
+Random::Random(unsigned long long seed) {
+   // Invariant: 0 <= i < 4
+   for (int i = 0; i < 4; i++) {
+      state_[i] = splitmix64(seed);
+   }
+}
+
+/*
+* This method returns the generator for stream (a, b) of a seed. It is
+* used to give every island, generation and chunk its own stream that
+* only depends on the seed and those numbers.
+*/
+Random Random::stream(unsigned long long seed, unsigned long long a,
+   unsigned long long b) {
+   // Mix each number in through splitmix64 before seeding
+   unsigned long long state = seed;
+   unsigned long long mixed = splitmix64(state);
+   state = mixed ^ a;
+   mixed = splitmix64(state);
+   state = mixed ^ b;
+   return Random(splitmix64(state));
+}
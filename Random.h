@@ -0,0 +1,90 @@
+/*
+* Random.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class is a small, fast random number generator (xoshiro256**) that
+* replaces the global rand(). Every Random object has its own 256-bit state,
+* so each thread, chunk or island can have its own stream and runs with the
+* same seed are reproducible. nextInt returns numbers without the modulo
+* bias of rand() % n.
+*/
+
+#pragma once
+
+class Random
+{
+public:
+   /*
+   * The constructor expands a 64-bit seed into the full state using
+   * splitmix64, so nearby seeds still give unrelated streams.
+   */
+   explicit Random(unsigned long long seed = 0);
+
+   /*
+   * This method returns the generator for stream (a, b) of a seed. It is
+   * used to give every island, generation and chunk its own stream that
+   * only depends on the seed and those numbers.
+   */
+   static Random stream(unsigned long long seed, unsigned long long a,
+      unsigned long long b = 0);
+
+   /*
+   * This method returns the next 64 random bits. It is defined in the
+   * header so it can be inlined into the mutation loops.
+   */
+   unsigned long long next() {
+      unsigned long long result = rotl(state_[1] * 5, 7) * 9;
+      unsigned long long t = state_[1] << 17;
+
+      state_[2] ^= state_[0];
+      state_[3] ^= state_[1];
+      state_[1] ^= state_[2];
+      state_[0] ^= state_[3];
+      state_[2] ^= t;
+      state_[3] = rotl(state_[3], 45);
+
+      return result;
+   }
+
+   /*
+   * This method returns a uniformly distributed number in [0, bound) using
+   * Lemire's multiply-and-reject method. bound must be at least 1.
+   */
+   int nextInt(int bound) {
+      unsigned long long range = (unsigned int) bound;
+      unsigned long long product = (next() >> 32) * range;
+      unsigned int low = (unsigned int) product;
+
+      // Reject the few values that would make some results more likely
+      if (low < range) {
+         unsigned int threshold = (unsigned int)(-(unsigned int) bound) % bound;
+         while (low < threshold) {
+            product = (next() >> 32) * range;
+            low = (unsigned int) product;
+         }
+      }
+
+      return (int)(product >> 32);
+   }
+
+   /*
+   * This method returns a uniformly distributed number in [0, 1) with 53
+   * random bits.
+   */
+   double nextDouble() {
+      return (next() >> 11) * (1.0 / 9007199254740992.0);
+   }
+
+private:
+   /*
+   * This helper rotates x left by k bits.
+   */
+   static unsigned long long rotl(unsigned long long x, int k) {
+      return (x << k) | (x >> (64 - k));
+   }
+
+   /*
+   * The 256-bit state of the generator. It is never all zero.
+   */
+   unsigned long long state_[4];
+};
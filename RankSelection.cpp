@@ -0,0 +1,87 @@
+/*
+* RankSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface with linear ranking. The
+* whole population is ordered from best to worst and the puzzle of rank r
+* (0 is the best) of n is picked with probability proportional to
+* 2(n - r) - 1, so the best is picked about twice as often as the median
+* and the worst almost never. Only the order of the scores matters, not
+* how far apart they are.
+*/
+
+#include "RankSelection.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+RankSelection& RankSelection::getInstance() {
+   // Create a static instance
+   static RankSelection instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method is an implementation from the Selection interface. It
+* ranks the population into scratch (ties keep index order) and then
+* draws each parent's rank from the linear ranking distribution. If the
+* scores span fewer than COUNTING_RANGE values (always true for 9x9
+* boards) they are ranked with a counting sort in O(size + count +
+* COUNTING_RANGE) time, otherwise with a comparison sort in
+* O(size log size + count) time.
+*/
+void RankSelection::select(const int* scores, int size, int /*survivors*/,
+   int count, int* parents, int* scratch, Random& rng) const {
+   // Find the range of the scores
+   int low = scores[0];
+   int high = scores[0];
+   // Invariant: low and high bound scores[0..i - 1]
+   for (int i = 1; i < size; i++) {
+      low = min(low, scores[i]);
+      high = max(high, scores[i]);
+   }
+
+   // scratch[r] becomes the index of the puzzle with rank r
+   if (high - low < COUNTING_RANGE) {
+      // Count each score, then turn the counts into starting positions
+      int start[COUNTING_RANGE + 1] = { 0 };
+      // Invariant: 0 <= i < size
+      for (int i = 0; i < size; i++) {
+         start[scores[i] - low + 1]++;
+      }
+      // Invariant: start[0..score] are positions
+      for (int score = 1; score <= high - low; score++) {
+         start[score] += start[score - 1];
+      }
+
+      // Invariant: 0 <= i < size
+      for (int i = 0; i < size; i++) {
+         scratch[start[scores[i] - low]] = i;
+         start[scores[i] - low]++;
+      }
+   } else {
+      // Too wide a range to count, so sort the indices instead
+      // Invariant: 0 <= i < size
+      for (int i = 0; i < size; i++) {
+         scratch[i] = i;
+      }
+      sort(scratch, scratch + size, [scores](int a, int b) {
+         return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+      });
+   }
+
+   // With u uniform in [0, 1), 1 - sqrt(1 - u) has density 2(1 - x) on
+   // [0, 1), which gives rank r a chance proportional to 2(n - r) - 1
+   // Invariant: 0 <= i < count
+   for (int i = 0; i < count; i++) {
+      double x = 1 - sqrt(1 - rng.nextDouble());
+      int rank = (int)(x * size);
+      parents[i] = scratch[rank < size ? rank : size - 1];
+   }
+}
@@ -0,0 +1,42 @@
+/*
+* RankSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface with linear ranking. The
+* whole population is ordered from best to worst and the puzzle of rank r
+* (0 is the best) of n is picked with probability proportional to
+* 2(n - r) - 1, so the best is picked about twice as often as the median
+* and the worst almost never. Only the order of the scores matters, not
+* how far apart they are.
+*/
+
+#pragma once
+#include "Selection.h"
+
+class RankSelection : public Selection
+{
+public:
+   /*
+   * This is the widest range of scores that is ranked with a counting
+   * sort. It covers every 9x9 sudoku score (27 units with at most 8
+   * repeats each, so 0 to 216) with room for bigger boards.
+   */
+   static const int COUNTING_RANGE = 1024;
+
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static RankSelection& getInstance();
+
+   /*
+   * This method is an implementation from the Selection interface. It
+   * ranks the population into scratch (ties keep index order) and then
+   * draws each parent's rank from the linear ranking distribution. If the
+   * scores span fewer than COUNTING_RANGE values (always true for 9x9
+   * boards) they are ranked with a counting sort in O(size + count +
+   * COUNTING_RANGE) time, otherwise with a comparison sort in
+   * O(size log size + count) time.
+   */
+   void select(const int* scores, int size, int survivors, int count,
+      int* parents, int* scratch, Random& rng) const;
+};
@@ -4,20 +4,41 @@
 * 3/6/2021
 *
 * This interface provides a method that is useful for mutating a puzzle.
-* It has only one pure virtual method, which takes in a reference to a
-* puzzle and returns a new puzzle that has been changed. The exact details
-* of how this method works depends on the subclass implementing it.
+* makeOffspring takes in a reference to a puzzle and returns a new puzzle
+* that has been changed, and crossover combines two parent puzzles into a
+* new one. The exact details of how these methods work depend on the
+* subclass implementing them.
 */
 
 #pragma once
 #include "Puzzle.h"
+#include "Random.h"
+
+/*
+* This enum picks how crossover combines two parents. Each row, box or cell
+* (for uniform) of the child comes from either parent with equal chance.
+* NO_CROSSOVER means offspring are made from one parent only.
+*/
+enum Crossover {
+   NO_CROSSOVER, ROW_CROSSOVER, BOX_CROSSOVER, UNIFORM_CROSSOVER
+};
 
 class Reproduction {
 public:
    /*
    * This pure virtual method takes a reference to a puzzle and returns
-   * a new puzzle that has been changed. The exact details of how this method
-   * works depends on the subclass implementing it.
+   * a new puzzle that has been changed, using rng for its random choices. The
+   * exact details of how this method works depends on the subclass
+   * implementing it.
+   */
+   virtual Puzzle* makeOffspring(const Puzzle& puzzle, Random& rng) const = 0;
+
+   /*
+   * This pure virtual method takes two parent puzzles that come from the
+   * same original puzzle and returns a new puzzle made of parts of both,
+   * picked with kind and rng. Fixed cells are the same in both parents and
+   * are never changed.
    */
-   virtual Puzzle* makeOffspring(const Puzzle& puzzle) const = 0;
+   virtual Puzzle* crossover(const Puzzle& mother, const Puzzle& father,
+      Crossover kind, Random& rng) const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+* Selection.h
+* Timothy Kozlov, Eric Pham
+*
+* This interface provides a method that picks the parents of the next
+* generation. SudokuPopulation#cull only decides which puzzles are
+* replaced (the best ones, the elites, survive as they are), and then a
+* Selection strategy decides which puzzles of the whole scored population
+* each offspring is made from. The exact details of how the parents are
+* picked depend on the subclass implementing it.
+*/
+
+#pragma once
+#include "Random.h"
+
+/*
+* This enum picks the selection strategy used by SudokuPopulation.
+*/
+enum SelectionKind {
+   TRUNCATION_SELECTION, TOURNAMENT_SELECTION, RANK_SELECTION
+};
+
+class Selection {
+public:
+   /*
+   * This pure virtual method fills parents with count indices into scores
+   * (which has size entries, lower is better). The first survivors entries
+   * are the ones cull kept, which are the best. The same index may be
+   * picked more than once. scratch has room for size ints and may be used
+   * freely. Implementations run in O(size + count) or O(size log size)
+   * time and never allocate.
+   */
+   virtual void select(const int* scores, int size, int survivors,
+      int count, int* parents, int* scratch, Random& rng) const = 0;
+};
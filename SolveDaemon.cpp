@@ -0,0 +1,377 @@
+/*
+* SolveDaemon.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These declarations run the solver as a long-running process that takes
+* puzzle jobs from clients and streams the results back as they finish
+* (see SolveService). Jobs come in over a Unix domain socket, where each
+* client gets its own connection, or over stdin with results written to
+* stdout.
+*
+* The protocol is one line per job:
+*
+*    <id> <puzzle> [<time limit ms>]
+*
+* where id is any word picked by the client and puzzle is 81 cells in
+* row-major order (1-9, with 0 or . for a blank). Blank lines and lines
+* starting with '#' are skipped. Every job gets exactly one reply line,
+* on the connection it came from:
+*
+*    <id> <status> <solution> <fitness> <generations> <queue ms> <solve ms>
+*
+* status is solved, unsolved (the generations ran out) or timeout (the
+* time limit ran out first, or the daemon is stopping). Replies come in
+* the order jobs finish, so the id says which job each one answers. A
+* line that cannot be read gets
+*
+*    <id> error <message>
+*
+* and a line longer than 256 bytes is answered with "<id> error line too
+* long" and skipped up to the next newline.
+*
+* When the queue is full the daemon stops reading from every connection
+* until there is room, so fast clients are slowed down rather than making
+* the daemon run out of memory. On SIGTERM the socket server stops
+* reading and answers every job it has taken in at once, with the best
+* board found so far. The stdin server stops at the end of its input,
+* once every job has been solved.
+*/
+
+#include "SolveDaemon.h"
+#include "Checkpoint.h"
+#include "PuzzleCorpus.h"
+#include "SolveService.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Milliseconds the accept loop waits before checking for SIGTERM
+const int ACCEPT_POLL_MS = 200;
+
+// Bytes read from a connection at a time
+const int READ_CHUNK = 1 << 16;
+
+// Longest job line kept; a valid one is well under 128 bytes
+const size_t MAX_LINE = 256;
+
+/*
+* This class is one client: where its jobs are read from and where its
+* replies go. Replies are written by the worker threads, so writes are
+* locked. It is shared by the reader and every job that came from it, and
+* closes its socket once the last of them is done.
+*/
+class Connection
+{
+public:
+   /*
+   * The constructor reads from in and writes to out. If owned is true
+   * the descriptor (in and out must then be the same socket) is closed
+   * by the destructor.
+   */
+   Connection(int in, int out, bool owned)
+      : in_(in), out_(out), owned_(owned), broken_(false) {
+   }
+
+   /*
+   * The destructor closes the socket if it is owned.
+   */
+   ~Connection() {
+      if (owned_) {
+         close(in_);
+      }
+   }
+
+   /*
+   * This method returns the descriptor jobs are read from.
+   */
+   int input() const {
+      return in_;
+   }
+
+   /*
+   * This method writes one whole reply line. Once a write fails (the
+   * client went away) every later reply is dropped.
+   */
+   void reply(const string& line) {
+      lock_guard<mutex> lock(mutex_);
+      const char* data = line.data();
+      size_t left = line.size();
+      // Invariant: the first line.size() - left bytes have been written
+      while (left > 0 && !broken_) {
+         ssize_t written = write(out_, data, left);
+         if (written < 0 && errno == EINTR) {
+            continue;
+         }
+         if (written <= 0) {
+            broken_ = true;
+            break;
+         }
+         data += written;
+         left -= written;
+      }
+   }
+
+private:
+   /*
+   * The descriptors jobs are read from and replies are written to.
+   */
+   int in_;
+   int out_;
+
+   /*
+   * True if the destructor closes the socket.
+   */
+   bool owned_;
+
+   /*
+   * True once a write has failed.
+   */
+   bool broken_;
+
+   /*
+   * This field keeps replies from different workers from mixing.
+   */
+   mutex mutex_;
+};
+
+/*
+* This helper formats the reply to a finished job.
+*/
+static string formatReply(const ServiceJob& job, const SolveResult& result,
+   double queuedMs, double solveMs) {
+   char cells[82];
+   result.best.writeCells(cells);
+   cells[81] = '\0';
+
+   const char* status = result.fitness == 0 ? "solved"
+      : result.cancelled ? "timeout" : "unsolved";
+   char numbers[96];
+   snprintf(numbers, sizeof(numbers), " %d %d %.3f %.3f\n", result.fitness,
+      result.generations, queuedMs, solveMs);
+   return job.id + " " + status + " " + cells + numbers;
+}
+
+/*
+* This helper reads one job line into job. Returns an empty string if it
+* worked, or the reason it did not.
+*/
+static string parseJob(const string& line, ServiceJob& job) {
+   istringstream words(line);
+   string puzzle;
+   string limit;
+   string extra;
+   words >> job.id >> puzzle >> limit >> extra;
+
+   if (puzzle.size() != 81) {
+      return "the puzzle must have 81 cells";
+   }
+   if (PuzzleCorpus::parseLine(puzzle.data(), puzzle.data() + 81,
+      job.puzzle) >= 0) {
+      return "the puzzle may only hold 0-9 and .";
+   }
+
+   if (!extra.empty()) {
+      return "too many fields";
+   }
+   job.timeLimitMs = 0;
+   if (!limit.empty()) {
+      try {
+         job.timeLimitMs = parseTimeLimit(limit);
+      }
+      catch (runtime_error& err) {
+         return err.what();
+      }
+   }
+   return "";
+}
+
+/*
+* This helper reads job lines from connection until it closes and hands
+* them to service. submit blocks while the queue is full, so a client that
+* sends faster than jobs are solved is simply not read from for a while.
+*/
+static void serveConnection(shared_ptr<Connection> connection,
+   SolveService& service) {
+   vector<char> buffer(READ_CHUNK);
+   string line;
+   bool discarding = false;
+
+   while (true) {
+      ssize_t count = read(connection->input(), buffer.data(), READ_CHUNK);
+      if (count < 0 && errno == EINTR) {
+         continue;
+      }
+      if (count <= 0) {
+         break;
+      }
+
+      // Invariant: line holds the unfinished line read so far, unless
+      // the line was too long and is being discarded
+      for (ssize_t i = 0; i < count; i++) {
+         if (buffer[i] == '\n' && discarding) {
+            discarding = false;
+            continue;
+         }
+         if (discarding) {
+            continue;
+         }
+         if (buffer[i] != '\n') {
+            line += buffer[i];
+            if (line.size() >= MAX_LINE) {
+               // Answer once, then skip the rest of the line
+               string id;
+               istringstream(line) >> id;
+               connection->reply(id + " error line too long\n");
+               line.clear();
+               discarding = true;
+            }
+            continue;
+         }
+
+         // Skip blank and comment lines
+         size_t first = line.find_first_not_of(" \t\r");
+         if (first != string::npos && line[first] != '#') {
+            ServiceJob job;
+            string error = parseJob(line, job);
+            if (!error.empty()) {
+               connection->reply(job.id + " error " + error + "\n");
+            } else {
+               // The job keeps its connection open until it is answered
+               job.done = [connection](const ServiceJob& done,
+                  const SolveResult& result, double queuedMs,
+                  double solveMs) {
+                  connection->reply(formatReply(done, result, queuedMs,
+                     solveMs));
+               };
+               service.submit(move(job));
+            }
+         }
+         line.clear();
+      }
+   }
+}
+
+/*
+* This helper serves jobs from stdin until it ends, writing replies to
+* stdout.
+*/
+static int serveStdin(SolveService& service) {
+   auto connection = make_shared<Connection>(0, 1, false);
+   serveConnection(connection, service);
+   return 0;
+}
+
+/*
+* This helper listens on the Unix socket at path and serves every client
+* on its own reader thread until SIGTERM.
+*/
+static int serveSocket(const string& path, SolveService& service) {
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (path.size() >= sizeof(address.sun_path)) {
+      cerr << "ERROR: Socket path is too long: " << path << endl;
+      return -1;
+   }
+   strcpy(address.sun_path, path.c_str());
+
+   int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listener < 0) {
+      cerr << "ERROR: Cannot create a socket" << endl;
+      return -1;
+   }
+
+   // A socket left behind by an earlier run would make bind fail
+   struct stat info;
+   if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+      unlink(path.c_str());
+   }
+   if (bind(listener, (sockaddr*) &address, sizeof(address)) != 0
+      || listen(listener, SOMAXCONN) != 0) {
+      cerr << "ERROR: Cannot listen on " << path << ": " << strerror(errno)
+         << endl;
+      close(listener);
+      return -1;
+   }
+
+   // Readers are detached; these count the ones still running so the
+   // shutdown can wait for them
+   mutex readersLock;
+   condition_variable readersDone;
+   int readers = 0;
+   vector<weak_ptr<Connection>> connections;
+   watchTermination();
+
+   // Poll so SIGTERM is noticed even when no client connects
+   while (!terminationRequested()) {
+      pollfd waiting = { listener, POLLIN, 0 };
+      if (poll(&waiting, 1, ACCEPT_POLL_MS) <= 0) {
+         continue;
+      }
+      int client = accept(listener, nullptr, nullptr);
+      if (client < 0) {
+         continue;
+      }
+
+      // Forget clients that are gone, then start a reader for this one
+      auto connection = make_shared<Connection>(client, client, true);
+      lock_guard<mutex> lock(readersLock);
+      connections.erase(remove_if(connections.begin(), connections.end(),
+         [](const weak_ptr<Connection>& weak) { return weak.expired(); }),
+         connections.end());
+      connections.push_back(connection);
+      readers++;
+      thread([&, connection]() {
+         serveConnection(connection, service);
+         lock_guard<mutex> done(readersLock);
+         readers--;
+         readersDone.notify_all();
+      }).detach();
+   }
+
+   // Stop taking jobs in and answer the ones taken in with what they have
+   service.cancelAll();
+   close(listener);
+   unlink(path.c_str());
+   unique_lock<mutex> lock(readersLock);
+   for (weak_ptr<Connection>& weak : connections) {
+      shared_ptr<Connection> connection = weak.lock();
+      if (connection != nullptr) {
+         shutdown(connection->input(), SHUT_RD);
+      }
+   }
+   readersDone.wait(lock, [&]() { return readers == 0; });
+   return 0;
+}
+
+/*
+* This function serves jobs as described above until SIGTERM (socket) or
+* the end of stdin, solving each one with options. Returns 0 on a clean
+* stop or -1 if the socket cannot be set up.
+*/
+int runDaemon(const DaemonOptions& daemon, const SolverOptions& options) {
+   // A client that hangs up must not kill the daemon
+   signal(SIGPIPE, SIG_IGN);
+
+   cerr << "Serving " << (daemon.socketPath == "-" ? "stdin"
+      : daemon.socketPath) << " with " << daemon.workers
+      << " workers and room for " << daemon.queueCapacity
+      << " queued jobs" << endl;
+
+   // Declared first so queued jobs are answered before anything else goes
+   SolveService service(options, daemon.workers, daemon.queueCapacity);
+   if (daemon.socketPath == "-") {
+      return serveStdin(service);
+   }
+   return serveSocket(daemon.socketPath, service);
+}
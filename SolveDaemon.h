@@ -0,0 +1,58 @@
+/*
+* SolveDaemon.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These declarations run the solver as a long-running process that takes
+* puzzle jobs from clients and streams the results back as they finish
+* (see SolveService). Jobs come in over a Unix domain socket, where each
+* client gets its own connection, or over stdin with results written to
+* stdout.
+*
+* The protocol is one line per job:
+*
+*    <id> <puzzle> [<time limit ms>]
+*
+* where id is any word picked by the client and puzzle is 81 cells in
+* row-major order (1-9, with 0 or . for a blank). Blank lines and lines
+* starting with '#' are skipped. Every job gets exactly one reply line,
+* on the connection it came from:
+*
+*    <id> <status> <solution> <fitness> <generations> <queue ms> <solve ms>
+*
+* status is solved, unsolved (the generations ran out) or timeout (the
+* time limit ran out first, or the daemon is stopping). Replies come in
+* the order jobs finish, so the id says which job each one answers. A
+* line that cannot be read gets
+*
+*    <id> error <message>
+*
+* and a line longer than 256 bytes is answered with "<id> error line too
+* long" and skipped up to the next newline.
+*
+* When the queue is full the daemon stops reading from every connection
+* until there is room, so fast clients are slowed down rather than making
+* the daemon run out of memory. On SIGTERM the socket server stops
+* reading and answers every job it has taken in at once, with the best
+* board found so far. The stdin server stops at the end of its input,
+* once every job has been solved.
+*/
+
+#pragma once
+#include <string>
+#include "Solver.h"
+
+/*
+* This struct holds the settings of the daemon.
+*/
+struct DaemonOptions {
+   string socketPath = "-";       // Unix socket to listen on, - for stdin
+   int workers = 1;               // jobs solved at the same time
+   int queueCapacity = 4;         // jobs that may wait for a worker
+};
+
+/*
+* This function serves jobs as described above until SIGTERM (socket) or
+* the end of stdin, solving each one with options. Returns 0 on a clean
+* stop or -1 if the socket cannot be set up.
+*/
+int runDaemon(const DaemonOptions& daemon, const SolverOptions& options);
@@ -0,0 +1,138 @@
+/*
+* SolveService.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class solves puzzles as jobs for a long-running process (see
+* SolveDaemon.h), so the cost of starting the program is paid once instead
+* of once per puzzle. Jobs wait in a queue of fixed capacity and are taken
+* by a fixed set of worker threads, so at most that many jobs are solved
+* at the same time. submit blocks while the queue is full, which pushes
+* back on whoever is reading the jobs in: they stop reading until there is
+* room again.
+*
+* Every job has a callback that is called on the worker thread when the
+* job is done. Jobs finish in any order, so the callback gets the job back
+* along with its result.
+*/
+
+#include "SolveService.h"
+#include "Random.h"
+
+/*
+* This helper hashes a job id (64-bit FNV-1a) so it can pick the job's
+* random stream.
+*/
+static unsigned long long hashId(const string& id) {
+   unsigned long long hash = 0xCBF29CE484222325ULL;
+   for (char c : id) {
+      hash = (hash ^ (unsigned char) c) * 0x100000001B3ULL;
+   }
+   return hash;
+}
+
+/*
+* The constructor starts workers threads that solve jobs using options,
+* with room for capacity jobs waiting in the queue. Every job gets its
+* own seed derived from options.seed and its id, so the same job always
+* gives the same answer (unless its time limit cuts it short).
+*/
+SolveService::SolveService(const SolverOptions& options, int workers,
+   int capacity) : options_(options), capacity_(max(1, capacity)),
+   running_(0), stopping_(false) {
+   if (workers < 1) {
+      throw runtime_error("A solve service needs at least one worker");
+   }
+   for (int i = 0; i < workers; i++) {
+      workers_.push_back(thread(&SolveService::workerLoop, this));
+   }
+}
+
+/*
+* The destructor waits for every queued job to be solved and joins the
+* workers.
+*/
+SolveService::~SolveService() {
+   {
+      lock_guard<mutex> lock(mutex_);
+      stopping_ = true;
+   }
+   notEmpty_.notify_all();
+
+   for (thread& worker : workers_) {
+      worker.join();
+   }
+}
+
+/*
+* This method adds job to the queue. If the queue is full it blocks
+* until a worker takes a job out.
+*/
+void SolveService::submit(ServiceJob job) {
+   job.queuedAt = chrono::steady_clock::now();
+
+   unique_lock<mutex> lock(mutex_);
+   notFull_.wait(lock, [this]() { return (int) queue_.size() < capacity_; });
+   queue_.push_back(move(job));
+   lock.unlock();
+
+   notEmpty_.notify_one();
+}
+
+/*
+* This method stops every job as soon as possible: running jobs return
+* the best puzzle they have found so far and queued jobs are answered
+* without any generations. It is safe to call from any thread.
+*/
+void SolveService::cancelAll() {
+   cancel_.cancel();
+}
+
+/*
+* This method returns the number of jobs that are queued or running.
+*/
+int SolveService::pending() {
+   lock_guard<mutex> lock(mutex_);
+   return (int) queue_.size() + running_;
+}
+
+/*
+* This method is the body of every worker thread.
+*/
+void SolveService::workerLoop() {
+   while (true) {
+      // Wait for a job, or for the destructor once the queue is empty
+      unique_lock<mutex> lock(mutex_);
+      notEmpty_.wait(lock, [this]() {
+         return !queue_.empty() || stopping_;
+      });
+      if (queue_.empty()) {
+         return;
+      }
+      ServiceJob job = move(queue_.front());
+      queue_.pop_front();
+      running_++;
+      lock.unlock();
+
+      // There is room in the queue again
+      notFull_.notify_one();
+
+      auto start = chrono::steady_clock::now();
+      SolverOptions jobOptions = options_;
+      jobOptions.seed = Random::stream(options_.seed, hashId(job.id)).next();
+      jobOptions.cancel = &cancel_;
+      if (job.timeLimitMs > 0) {
+         jobOptions.timeLimitMs = job.timeLimitMs;
+      }
+      SolveResult result = solve(job.puzzle, jobOptions);
+      auto end = chrono::steady_clock::now();
+
+      chrono::duration<double, milli> queued = start - job.queuedAt;
+      chrono::duration<double, milli> solving = end - start;
+      if (job.done) {
+         job.done(job, result, queued.count(), solving.count());
+      }
+
+      lock.lock();
+      running_--;
+   }
+}
@@ -0,0 +1,136 @@
+/*
+* SolveService.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class solves puzzles as jobs for a long-running process (see
+* SolveDaemon.h), so the cost of starting the program is paid once instead
+* of once per puzzle. Jobs wait in a queue of fixed capacity and are taken
+* by a fixed set of worker threads, so at most that many jobs are solved
+* at the same time. submit blocks while the queue is full, which pushes
+* back on whoever is reading the jobs in: they stop reading until there is
+* room again.
+*
+* Every job has a callback that is called on the worker thread when the
+* job is done. Jobs finish in any order, so the callback gets the job back
+* along with its result.
+*/
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CancellationToken.h"
+#include "Solver.h"
+#include "Sudoku.h"
+
+/*
+* This struct is one puzzle to solve.
+*/
+struct ServiceJob {
+   string id;                     // name given by the client
+   Sudoku puzzle;                 // the puzzle to solve
+   double timeLimitMs = 0;        // time budget, 0 for the service default
+
+   /*
+   * Called on the worker thread once the job is done, with the result,
+   * the milliseconds the job waited in the queue and the milliseconds it
+   * took to solve.
+   */
+   function<void(const ServiceJob&, const SolveResult&, double, double)>
+      done;
+
+   // Set by submit, used to measure the time spent in the queue
+   chrono::steady_clock::time_point queuedAt;
+};
+
+class SolveService
+{
+public:
+   /*
+   * The constructor starts workers threads that solve jobs using options,
+   * with room for capacity jobs waiting in the queue. Every job gets its
+   * own seed derived from options.seed and its id, so the same job always
+   * gives the same answer (unless its time limit cuts it short).
+   */
+   SolveService(const SolverOptions& options, int workers, int capacity);
+
+   /*
+   * The destructor waits for every queued job to be solved and joins the
+   * workers.
+   */
+   ~SolveService();
+
+   /*
+   * This method adds job to the queue. If the queue is full it blocks
+   * until a worker takes a job out.
+   */
+   void submit(ServiceJob job);
+
+   /*
+   * This method stops every job as soon as possible: running jobs return
+   * the best puzzle they have found so far and queued jobs are answered
+   * without any generations. It is safe to call from any thread.
+   */
+   void cancelAll();
+
+   /*
+   * This method returns the number of jobs that are queued or running.
+   */
+   int pending();
+
+private:
+   /*
+   * This method is the body of every worker thread.
+   */
+   void workerLoop();
+
+   /*
+   * The settings every job is solved with.
+   */
+   SolverOptions options_;
+
+   /*
+   * The most jobs that may wait in the queue.
+   */
+   int capacity_;
+
+   /*
+   * The jobs waiting for a worker, oldest first.
+   */
+   deque<ServiceJob> queue_;
+
+   /*
+   * The number of jobs the workers are solving right now.
+   */
+   int running_;
+
+   /*
+   * This field is set by the destructor to stop the workers once the
+   * queue is empty.
+   */
+   bool stopping_;
+
+   /*
+   * This token is the parent of every job's budget, so cancelAll reaches
+   * every running job.
+   */
+   CancellationToken cancel_;
+
+   /*
+   * These fields guard the queue and let workers sleep while it is empty
+   * and submit sleep while it is full.
+   */
+   mutex mutex_;
+   condition_variable notEmpty_;
+   condition_variable notFull_;
+
+   /*
+   * The worker threads.
+   */
+   vector<thread> workers_;
+};
@@ -0,0 +1,541 @@
+/*
+* Solver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions run the genetic algorithm on one puzzle from start to
+* finish. SolverOptions holds every setting that can be given on the
+* command line, and solve runs either a single SudokuPopulation (optionally
+* on a thread pool) or an IslandModel and returns the best puzzle it found.
+* The command line program, batch mode and benchmarks all go through here
+* so they behave the same way.
+*/
+
+#include "Solver.h"
+#include "AdaptiveController.h"
+#include "AllocationCounter.h"
+#include "Checkpoint.h"
+#include "ConstraintPropagator.h"
+#include "ExactSolver.h"
+#include "GeneticEngine.h"
+#include "IslandModel.h"
+#include "PermutationFactory.h"
+#include "PermutationFitness.h"
+#include "PermutationOffspring.h"
+#include "RankSelection.h"
+#include "ThreadPool.h"
+#include "TournamentSelection.h"
+#include "TruncationSelection.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+/*
+* This helper parses the value after a flag as a whole number that is at
+* least min. Throws a runtime_error if it is missing or invalid.
+*/
+static long long flagValue(int argc, char* argv[], int& i, long long min) {
+   string flag = argv[i];
+   if (i + 1 >= argc) {
+      throw runtime_error(flag + " needs a value");
+   }
+
+   long long value;
+   try {
+      value = stoll(argv[++i]);
+   }
+   catch (exception&) {
+      throw runtime_error(flag + " needs a number");
+   }
+
+   if (value < min) {
+      throw runtime_error(flag + " must be at least " + to_string(min));
+   }
+   return value;
+}
+
+/*
+* This function reads text as a time limit in milliseconds. Fractions are
+* allowed. Throws a runtime_error unless all of text is a finite number
+* above 0.
+*/
+double parseTimeLimit(const string& text) {
+   const char* start = text.c_str();
+   char* end = nullptr;
+   double value = strtod(start, &end);
+   if (end == start || *end != '\0' || !isfinite(value) || value <= 0) {
+      throw runtime_error("the time limit must be a positive number");
+   }
+   return value;
+}
+
+/*
+* This function checks whether argv[i] is one of the solver flags. If it is,
+* it stores the setting in options, moves i past any value the flag takes
+* and returns true. Returns false for flags it does not know. Throws a
+* runtime_error if the flag's value is missing or invalid.
+*/
+bool parseSolverFlag(int argc, char* argv[], int& i, SolverOptions& options) {
+   string flag = argv[i];
+
+   if (flag == "--engine") {
+      // ga (genetic algorithm), exact (backtracking search) or template
+      // (GeneticEngine)
+      string value = i + 1 < argc ? argv[++i] : "";
+      if (value == "ga") {
+         options.engine = GA_ENGINE;
+      } else if (value == "exact") {
+         options.engine = EXACT_ENGINE;
+      } else if (value == "template") {
+         options.engine = TEMPLATE_ENGINE;
+      } else {
+         throw runtime_error("--engine must be ga, exact or template");
+      }
+   } else if (flag == "--checkpoint") {
+      // Save the population here every --checkpoint-every generations and
+      // when SIGTERM arrives
+      if (i + 1 >= argc) {
+         throw runtime_error("--checkpoint needs a file");
+      }
+      options.checkpointFile = argv[++i];
+   } else if (flag == "--checkpoint-every") {
+      // Generations between checkpoints, 0 for only on SIGTERM
+      options.checkpointEvery = (int) flagValue(argc, argv, i, 0);
+   } else if (flag == "--resume") {
+      // Continue the run saved in a checkpoint
+      if (i + 1 >= argc) {
+         throw runtime_error("--resume needs a file");
+      }
+      options.resumeFile = argv[++i];
+   } else if (flag == "--time-limit") {
+      // Milliseconds each puzzle may take before the best so far is used
+      if (i + 1 >= argc) {
+         throw runtime_error("--time-limit needs a value");
+      }
+      try {
+         options.timeLimitMs = parseTimeLimit(argv[++i]);
+      }
+      catch (runtime_error&) {
+         throw runtime_error("--time-limit must be a positive number");
+      }
+   } else if (flag == "--no-propagate") {
+      // Start the GA from the puzzle as given
+      options.propagate = false;
+   } else if (flag == "--selection") {
+      // How the parents of each offspring are picked from the population
+      string value = i + 1 < argc ? argv[++i] : "";
+      if (value == "truncation") {
+         options.selection = TRUNCATION_SELECTION;
+      } else if (value == "tournament") {
+         options.selection = TOURNAMENT_SELECTION;
+      } else if (value == "rank") {
+         options.selection = RANK_SELECTION;
+      } else {
+         throw runtime_error(
+            "--selection must be truncation, tournament or rank");
+      }
+   } else if (flag == "--cull") {
+      // Fraction of the population replaced every generation (at least one)
+      string value = i + 1 < argc ? argv[++i] : "";
+      try {
+         options.cullPercent = stod(value);
+      }
+      catch (exception&) {
+         throw runtime_error("--cull needs a number");
+      }
+      if (options.cullPercent < 0 || options.cullPercent >= 1) {
+         throw runtime_error("--cull must be at least 0 and less than 1");
+      }
+   } else if (flag == "--mutation") {
+      // Mutation rate in percent (the starting rate with --adaptive)
+      options.mutationPercent = (int) flagValue(argc, argv, i, 0);
+      if (options.mutationPercent > 100) {
+         throw runtime_error("--mutation must be at most 100");
+      }
+   } else if (flag == "--adaptive") {
+      // Change the mutation rate with progress and restart when stuck
+      options.adaptive = true;
+   } else if (flag == "--restart-after") {
+      // Stagnant generations before a restart, 0 for never (implies
+      // --adaptive)
+      options.adaptive = true;
+      options.restartAfter = (int) flagValue(argc, argv, i, 0);
+   } else if (flag == "--arena") {
+      // Keep the population in two preallocated slabs
+      options.arena = true;
+   } else if (flag == "--cache") {
+      // Size of the fitness transposition table
+      options.cacheEntries = (int) flagValue(argc, argv, i, 0);
+   } else if (flag == "--no-duplicates") {
+      // Remake offspring that already exist in the generation
+      options.rejectDuplicates = true;
+   } else if (flag == "--seed") {
+      // Same seed and thread/chunk settings give the same run
+      options.seed = (unsigned long long) flagValue(argc, argv, i, 0);
+   } else if (flag == "--threads") {
+      // Worker pool size
+      options.threads = (int) flagValue(argc, argv, i, 1);
+   } else if (flag == "--chunk") {
+      // Number of puzzles per chunk
+      options.chunkSize = (int) flagValue(argc, argv, i, 1);
+   } else if (flag == "--islands") {
+      // Run this many populations that trade their best puzzles
+      options.islands = (int) flagValue(argc, argv, i, 1);
+   } else if (flag == "--migrate-every") {
+      // Generations between migrations
+      options.migrationInterval = (int) flagValue(argc, argv, i, 1);
+   } else if (flag == "--migrants") {
+      // Puzzles sent to the next island at each migration
+      options.migrants = (int) flagValue(argc, argv, i, 0);
+   } else if (flag == "--encoding") {
+      // cells (random digits) or permutation (boxes are permutations)
+      string value = i + 1 < argc ? argv[++i] : "";
+      if (value == "cells") {
+         options.encoding = CELL_ENCODING;
+      } else if (value == "permutation") {
+         options.encoding = PERMUTATION_ENCODING;
+      } else {
+         throw runtime_error("--encoding must be cells or permutation");
+      }
+   } else if (flag == "--crossover") {
+      // How two parents are combined into an offspring
+      string value = i + 1 < argc ? argv[++i] : "";
+      if (value == "none") {
+         options.crossover = NO_CROSSOVER;
+      } else if (value == "row") {
+         options.crossover = ROW_CROSSOVER;
+      } else if (value == "box") {
+         options.crossover = BOX_CROSSOVER;
+      } else if (value == "uniform") {
+         options.crossover = UNIFORM_CROSSOVER;
+      } else {
+         throw runtime_error("--crossover must be none, row, box or uniform");
+      }
+   } else {
+      return false;
+   }
+
+   return true;
+}
+
+// Clock used to time the phases of a solve
+typedef chrono::steady_clock Clock;
+
+/*
+* This helper returns the seconds from start to end.
+*/
+static double secondsBetween(Clock::time_point start, Clock::time_point end) {
+   return chrono::duration<double>(end - start).count();
+}
+
+/*
+* This helper runs islands of the genetic algorithm (see IslandModel).
+*/
+static SolveResult solveIslands(const Sudoku& puzzle,
+   const SolverOptions& options, const CancellationToken& budget,
+   Clock::time_point started) {
+   IslandOptions islandOptions;
+   islandOptions.islands = options.islands;
+   islandOptions.popSize = options.popSize;
+   islandOptions.maxGens = options.maxGens;
+   islandOptions.migrationInterval = options.migrationInterval;
+   islandOptions.migrants = options.migrants;
+   islandOptions.cullPercent = options.cullPercent;
+   islandOptions.arena = options.arena;
+   islandOptions.cacheEntries = options.cacheEntries;
+   islandOptions.rejectDuplicates = options.rejectDuplicates;
+   islandOptions.seed = options.seed;
+   islandOptions.encoding = options.encoding;
+   islandOptions.crossover = options.crossover;
+   islandOptions.selection = options.selection;
+   islandOptions.mutationPercent = options.mutationPercent;
+   islandOptions.adaptive = options.adaptive;
+   islandOptions.restartAfter = options.restartAfter;
+   islandOptions.cancel = &budget;
+
+   IslandModel model(puzzle, islandOptions);
+   SolveResult result;
+   result.setupSeconds = secondsBetween(started, Clock::now());
+   long long allocsBefore = allocationCount();
+   model.run();
+
+   result.allocations = allocationCount() - allocsBefore;
+   result.best = *(Sudoku*) model.bestIndividual();
+   result.best.setCandidates(nullptr);
+   result.fitness = model.bestFitness();
+   result.generations = model.generations();
+   result.stats = model.getStats();
+   result.cancelled = result.fitness != 0
+      && result.generations < options.maxGens && budget.isCancelled();
+   return result;
+}
+
+/*
+* This helper solves the puzzle with the exact engine. An unsolvable puzzle,
+* or one whose search ran out of budget, gives back the puzzle itself with
+* its (nonzero) fitness.
+*/
+static SolveResult solveExact(const Sudoku& puzzle,
+   const CancellationToken& budget) {
+   SolveResult result;
+   long long allocsBefore = allocationCount();
+
+   bool solved = ExactSolver::getInstance().solve(puzzle, result.best,
+      &result.nodes, &budget);
+
+   result.allocations = allocationCount() - allocsBefore;
+   result.fitness = SudokuFitness::getInstance().howFitMask(result.best);
+   result.cancelled = !solved && budget.isCancelled();
+   return result;
+}
+
+/*
+* This helper returns true if the budget is used up, or if there is not
+* enough of it left for another generation (assuming the next one takes
+* as long as the last one did).
+*/
+static bool outOfTime(const CancellationToken& budget, double lastSeconds) {
+   return budget.isCancelled() || budget.remainingSeconds() < lastSeconds;
+}
+
+/*
+* This helper runs the genetic algorithm with a GeneticEngine made of the
+* given classes.
+*/
+template <typename FactoryT, typename FitnessT, typename OffspringT,
+   typename SelectionT>
+static SolveResult runEngine(const Sudoku& puzzle,
+   const SolverOptions& options, const CancellationToken& budget,
+   Clock::time_point started) {
+   GeneticEngine<Sudoku, FactoryT, FitnessT, OffspringT, SelectionT> engine(
+      puzzle, options.popSize, options.seed);
+   engine.setMutationPercent(options.mutationPercent);
+
+   SolveResult result;
+   Clock::time_point generationStart = Clock::now();
+   result.setupSeconds = secondsBetween(started, generationStart);
+   double lastSeconds = 0;
+   long long allocsBefore = allocationCount();
+
+   for (int i = 1; i <= options.maxGens && engine.bestFitness() != 0; i++) {
+      if (outOfTime(budget, lastSeconds)) {
+         result.cancelled = true;
+         break;
+      }
+      result.generations = i;
+      engine.cull(options.cullPercent);
+      Clock::time_point culled = Clock::now();
+      engine.newGeneration();
+      Clock::time_point done = Clock::now();
+
+      result.phases.cullSeconds += secondsBetween(generationStart, culled);
+      result.phases.newGenerationSeconds += secondsBetween(culled, done);
+      lastSeconds = secondsBetween(generationStart, done);
+      generationStart = done;
+   }
+
+   result.allocations = allocationCount() - allocsBefore;
+   result.best = engine.bestBoard();
+   result.best.setCandidates(nullptr);
+   result.fitness = engine.bestFitness();
+   return result;
+}
+
+/*
+* This helper picks the selection class of the GeneticEngine.
+*/
+template <typename FactoryT, typename FitnessT, typename OffspringT>
+static SolveResult runEngineWith(const Sudoku& puzzle,
+   const SolverOptions& options, const CancellationToken& budget,
+   Clock::time_point started) {
+   if (options.selection == TOURNAMENT_SELECTION) {
+      return runEngine<FactoryT, FitnessT, OffspringT, TournamentSelection>(
+         puzzle, options, budget, started);
+   } else if (options.selection == RANK_SELECTION) {
+      return runEngine<FactoryT, FitnessT, OffspringT, RankSelection>(
+         puzzle, options, budget, started);
+   }
+   return runEngine<FactoryT, FitnessT, OffspringT, TruncationSelection>(
+      puzzle, options, budget, started);
+}
+
+/*
+* This helper solves the puzzle with a GeneticEngine, picking its classes
+* from the encoding and selection settings.
+*/
+static SolveResult solveTemplate(const Sudoku& puzzle,
+   const SolverOptions& options, const CancellationToken& budget,
+   Clock::time_point started) {
+   if (options.encoding == PERMUTATION_ENCODING) {
+      return runEngineWith<PermutationFactory, PermutationFitness,
+         PermutationOffspring>(puzzle, options, budget, started);
+   }
+   return runEngineWith<SudokuFactory, SudokuFitness, SudokuOffspring>(
+      puzzle, options, budget, started);
+}
+
+/*
+* This helper runs the genetic algorithm with a single SudokuPopulation.
+*/
+static SolveResult solvePopulation(const Sudoku& puzzle,
+   const SolverOptions& options, const CancellationToken& budget,
+   Clock::time_point started) {
+   SudokuPopulation pop(puzzle, options.popSize, options.seed, options.arena,
+      options.encoding);
+   pop.setFitnessCache(options.cacheEntries);
+   pop.setRejectDuplicates(options.rejectDuplicates);
+   pop.setCrossover(options.crossover);
+   pop.setSelection(options.selection);
+   pop.setMutationPercent(options.mutationPercent);
+
+   // Run the chunks of each generation on a pool of workers
+   ThreadPool pool(options.threads);
+   pop.setThreads(&pool, options.chunkSize);
+
+   // Steer the mutation rate and restarts if asked to
+   AdaptiveOptions adaptiveOptions;
+   adaptiveOptions.restartAfter = options.restartAfter;
+   AdaptiveController controller(pop, adaptiveOptions);
+
+   // Pick up where a saved run stopped (the streams of every generation
+   // follow from the seed, so the rest of the run is the same)
+   SolveResult result;
+   if (!options.resumeFile.empty()) {
+      AdaptiveState state;
+      pop.loadCheckpoint(options.resumeFile, state);
+      controller.setState(state);
+      result.generations = (int) pop.getGeneration();
+   }
+
+   Clock::time_point generationStart = Clock::now();
+   result.setupSeconds = secondsBetween(started, generationStart);
+   double lastSeconds = 0;
+
+   // Count allocations made by the generation loop only
+   long long allocsBefore = allocationCount();
+
+   for (int i = result.generations + 1; i <= options.maxGens
+      && pop.bestFitness() != 0; i++) {
+      // The best puzzle so far is the answer once time runs out
+      if (outOfTime(budget, lastSeconds)) {
+         result.cancelled = true;
+         break;
+      }
+      result.generations = i;
+
+      // Scoring is only timed on sampled generations
+      bool sampled = options.telemetry != nullptr
+         && options.telemetry->isSampled(i);
+      long long scoreNanos = 0;
+      if (sampled) {
+         pop.setTimeScoring(true);
+         scoreNanos = pop.getStats().scoreNanos;
+      }
+
+      pop.cull(options.cullPercent);
+      Clock::time_point culled = Clock::now();
+      pop.newGeneration();
+      Clock::time_point done = Clock::now();
+
+      PhaseTimes times;
+      times.cullSeconds = secondsBetween(generationStart, culled);
+      times.newGenerationSeconds = secondsBetween(culled, done);
+      result.phases.cullSeconds += times.cullSeconds;
+      result.phases.newGenerationSeconds += times.newGenerationSeconds;
+      if (sampled) {
+         pop.setTimeScoring(false);
+         times.scoreSeconds = (pop.getStats().scoreNanos - scoreNanos) / 1e9;
+         result.phases.scoreSeconds += times.scoreSeconds;
+         options.telemetry->record(i, pop, times);
+      }
+
+      if (options.adaptive) {
+         controller.update();
+      }
+
+      // Save every checkpointEvery generations, and before stopping early
+      // on SIGTERM (other callers of watchTermination, like the daemon,
+      // stop runs through options.cancel instead)
+      bool checkpoints = !options.checkpointFile.empty();
+      bool stop = checkpoints && terminationRequested();
+      bool due = options.checkpointEvery > 0
+         && i % options.checkpointEvery == 0;
+      if (checkpoints && (stop || due)) {
+         pop.saveCheckpoint(options.checkpointFile, controller.getState());
+      }
+      if (stop) {
+         result.interrupted = true;
+         break;
+      }
+
+      Clock::time_point end = Clock::now();
+      lastSeconds = secondsBetween(generationStart, end);
+      generationStart = end;
+   }
+
+   result.allocations = allocationCount() - allocsBefore;
+   if (options.telemetry != nullptr) {
+      options.telemetry->flush();
+   }
+   result.best = *(Sudoku*) pop.bestIndividual();
+   result.best.setCandidates(nullptr);
+   result.fitness = pop.bestFitness();
+   result.stats = pop.getStats();
+   return result;
+}
+
+/*
+* This function runs the genetic algorithm on puzzle using options and
+* returns the best puzzle found. If options has a time limit or a
+* cancellation token, the run stops as soon as the budget runs out or the
+* token is cancelled and returns the best puzzle found so far (the exact
+* engine ignores both).
+*/
+SolveResult solve(const Sudoku& puzzle, const SolverOptions& options) {
+   Clock::time_point started = Clock::now();
+   SolveResult result;
+
+   // The budget starts now, so propagation and setup count against it
+   CancellationToken budget(options.timeLimitMs, options.cancel);
+
+   if (options.engine == EXACT_ENGINE) {
+      result = solveExact(puzzle, budget);
+      result.totalSeconds = secondsBetween(started, Clock::now());
+      return result;
+   }
+
+   // Fill forced cells first. A puzzle that is solved (or found to have no
+   // solution) here needs no generations at all.
+   Sudoku start = puzzle;
+   unsigned short candidates[81];
+   bool finished = false;
+   if (options.propagate) {
+      bool valid = ConstraintPropagator::getInstance().propagate(start,
+         candidates);
+      start.setCandidates(candidates);
+
+      const int* cells = start.getCells();
+      bool complete = find(cells, cells + 81, 0) == cells + 81;
+      if (!valid || complete) {
+         result.best = start;
+         result.best.setCandidates(nullptr);
+         result.fitness = SudokuFitness::getInstance().howFitMask(start);
+         result.setupSeconds = secondsBetween(started, Clock::now());
+         finished = true;
+      }
+   }
+
+   if (finished) {
+      // Nothing left for the genetic algorithm to do
+   } else if (options.engine == TEMPLATE_ENGINE) {
+      result = solveTemplate(start, options, budget, started);
+   } else if (options.islands > 0) {
+      result = solveIslands(start, options, budget, started);
+   } else {
+      result = solvePopulation(start, options, budget, started);
+   }
+
+   result.totalSeconds = secondsBetween(started, Clock::now());
+   return result;
+}
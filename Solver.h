@@ -0,0 +1,110 @@
+/*
+* Solver.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* These functions run the genetic algorithm on one puzzle from start to
+* finish. SolverOptions holds every setting that can be given on the
+* command line, and solve runs either a single SudokuPopulation (optionally
+* on a thread pool), an IslandModel or the ExactSolver engine and returns
+* the best puzzle it found.
+* The command line program, batch mode and benchmarks all go through here
+* so they behave the same way.
+*/
+
+#pragma once
+#include <string>
+#include "Sudoku.h"
+#include "SudokuPopulation.h"
+#include "SudokuOffspring.h"
+#include "Telemetry.h"
+#include "CancellationToken.h"
+
+/*
+* This enum picks what solves the puzzle: the genetic algorithm, the
+* exact backtracking search of ExactSolver, or the genetic algorithm run
+* by GeneticEngine (no virtual calls; one thread, mutation only, and only
+* the encoding, selection, cull, mutation and propagation settings apply).
+*/
+enum Engine { GA_ENGINE, EXACT_ENGINE, TEMPLATE_ENGINE };
+
+/*
+* This struct holds the settings of a run. The defaults match the original
+* program (cull 90% every generation, no extra features turned on) except
+* for propagate, which is on: forced cells are filled in before the genetic
+* algorithm starts, so easy puzzles are often solved with 0 generations.
+* --no-propagate gives the original behaviour.
+*/
+struct SolverOptions {
+   Engine engine = GA_ENGINE;     // genetic algorithm or exact search
+   int popSize = 1000;            // puzzles in the population (per island)
+   int maxGens = 1000;            // generations before giving up
+   double cullPercent = 0.9;      // passed to SudokuPopulation#cull
+   bool arena = false;            // preallocated slab storage
+   int cacheEntries = 0;          // fitness cache size, 0 for none
+   bool rejectDuplicates = false; // remake duplicate offspring
+   int threads = 1;               // worker pool size for one population
+   int chunkSize = 1024;          // puzzles per chunk
+   unsigned long long seed = 0;   // seed every random stream comes from
+   int islands = 0;               // island count, 0 for a single population
+   int migrationInterval = 50;    // generations between migrations
+   int migrants = 5;              // puzzles sent at each migration
+   Encoding encoding = CELL_ENCODING; // how boards are filled and mutated
+   Crossover crossover = NO_CROSSOVER; // how parents are combined
+   bool propagate = true;         // fill forced cells before the GA starts
+   SelectionKind selection = TRUNCATION_SELECTION; // how parents are picked
+   int mutationPercent = SudokuOffspring::MUTATION_PERCENT; // starting rate
+   bool adaptive = false;         // adaptive mutation rate and restarts
+   int restartAfter = 200;        // stagnant generations before a restart
+   Telemetry* telemetry = nullptr; // per-generation records, nullptr for
+                                   // none (single population runs only)
+   string checkpointFile;         // where checkpoints are saved, "" for none
+   int checkpointEvery = 0;       // generations between checkpoints, 0 for
+                                  // only on SIGTERM
+   string resumeFile;             // checkpoint to resume from, "" for none
+   double timeLimitMs = 0;        // time budget of one solve, 0 for none
+   const CancellationToken* cancel = nullptr; // stops the run when
+                                  // cancelled, nullptr for none
+};
+
+/*
+* This struct holds the outcome of a run.
+*/
+struct SolveResult {
+   Sudoku best;                   // best puzzle found
+   int fitness = -1;              // fitness score of best
+   int generations = 0;           // generations that were run
+   PopulationStats stats;         // cache and duplicate counters
+   long long allocations = 0;     // heap allocations in the generation loop
+   long long nodes = 0;           // cells tried by the exact engine
+   bool interrupted = false;      // stopped early by SIGTERM
+   bool cancelled = false;        // stopped by the time limit or token
+   double setupSeconds = 0;       // propagation and filling the population
+   PhaseTimes phases;             // time in cull and newGeneration (single
+                                  // population and template engine only)
+   double totalSeconds = 0;       // the whole solve
+};
+
+/*
+* This function reads text as a time limit in milliseconds. Fractions are
+* allowed. Throws a runtime_error unless all of text is a finite number
+* above 0.
+*/
+double parseTimeLimit(const string& text);
+
+/*
+* This function checks whether argv[i] is one of the solver flags. If it is,
+* it stores the setting in options, moves i past any value the flag takes
+* and returns true. Returns false for flags it does not know. Throws a
+* runtime_error if the flag's value is missing or invalid.
+*/
+bool parseSolverFlag(int argc, char* argv[], int& i, SolverOptions& options);
+
+/*
+* This function runs the genetic algorithm on puzzle using options and
+* returns the best puzzle found. If options has a time limit or a
+* cancellation token, the run stops as soon as the budget runs out or the
+* token is cancelled and returns the best puzzle found so far (the exact
+* engine checks them every ExactSolver::POLL_NODES cells and then gives
+* back the puzzle as it was).
+*/
+SolveResult solve(const Sudoku& puzzle, const SolverOptions& options);
@@ -4,11 +4,16 @@
 * 3/6/2021
 *
 * This class implements the Puzzle interface. It represents either a solved
-* or unsolved Puzzle solution. In the backend, it uses a 2d array of 81 ints
-* and bools to hold the data of the sudoku board.
+* or unsolved Puzzle solution. In the backend, it uses 2d arrays of 81 ints
+* and bools to hold the data of the sudoku board, plus the digit counts of
+* every row, column and box, a Zobrist hash and a pending fitness delta so
+* that a change can be scored without rescanning the board. That makes it
+* a working board: SudokuPopulation stores its boards as CompactSudoku and
+* only unpacks them into scratch Sudoku boards to make offspring.
 */
 
 #include "Sudoku.h"
+#include "SudokuTables.h"
 #include <exception>
 #include <string>
 
@@ -16,13 +21,26 @@
 * This is the default constructor. It represents a completely empty puzzle
 * with data_ all set to 0 and fixed_ all set to false (default values)
 */
-Sudoku::Sudoku() : data_{ 0 }, fixed_{ false } { }
+Sudoku::Sudoku() : data_{ 0 }, fixed_{ false }, fitnessDelta_(0), hash_(0),
+   candidates_(nullptr) {
+   countUnits();
+}
 
 /*
 * This copy constructor copies the data_ and fixed_ arrays from another sudoku
 * object. This is used by SudokuOffspring to clone and mutate.
 */
 Sudoku::Sudoku(const Sudoku& other) {
+   // Use the assignment operator to copy everything
+   *this = other;
+}
+
+/*
+* This assignment operator copies the data_ and fixed_ arrays from another
+* sudoku object just like the copy constructor. It lets SudokuPopulation
+* reuse puzzles that are already allocated instead of calling new.
+*/
+Sudoku& Sudoku::operator=(const Sudoku& other) {
    // Loop invariant: 0 <= row < data_.length_
    for (int row = 0; row < 9; row++) {
       // Loop invariant: 0 <= col < data_[row].length_
@@ -32,6 +50,21 @@ Sudoku::Sudoku(const Sudoku& other) {
          fixed_[row][col] = other.fixed_[row][col];
       }
    }
+
+   // Copy the unit counts so setDigitAt can keep tracking the fitness
+   for (int unit = 0; unit < 27; unit++) {
+      for (int digit = 0; digit < 10; digit++) {
+         unitFreq_[unit][digit] = other.unitFreq_[unit][digit];
+      }
+   }
+
+   // The copy starts with the same score and hash as other
+   fitnessDelta_ = 0;
+   hash_ = other.hash_;
+
+   // Boards of one population share the same candidate masks
+   candidates_ = other.candidates_;
+   return *this;
 }
 
 /*
@@ -84,6 +117,10 @@ istream& Sudoku::readPuzzle(istream& is) {
       i++; // increment i by one.
    }
 
+   // data_ was written directly, so rebuild the unit counts
+   countUnits();
+   fitnessDelta_ = 0;
+
    return is;
 }
 
@@ -122,6 +159,20 @@ ostream& Sudoku::writePuzzle(ostream& os) const {
    return os;
 }
 
+/*
+* This method writes the 81 digits of the puzzle in row-major order as
+* characters '0'-'9' into out (no terminating null). It is the compact
+* one-line format used by batch mode.
+*/
+void Sudoku::writeCells(char* out) const {
+   const int* cells = getCells();
+
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      out[cell] = (char)('0' + cells[cell]);
+   }
+}
+
 /*
 * This method returns the digit stored at row and col in the data_.
 */
@@ -136,26 +187,141 @@ int Sudoku::getDigitAt(int row, int col) const {
 }
 
 /*
-* This method sets the digit in the puzzle at row and col to digit as long
-* as it is not fixed (check fixed_). If it is, it does nothing and returns
-* false. If the change succeeds, return true.
+* This method returns a pointer to the 81 digits of the puzzle stored in
+* row-major order (cell = row * 9 + col). It does no bounds checking, so it
+* is meant for the fitness kernels that use the tables in SudokuTables.h.
 */
-bool Sudoku::setDigitAt(int row, int col, int digit) {
+const int* Sudoku::getCells() const {
+   return &data_[0][0];
+}
+
+/*
+* This method copies 81 digits (row-major order) into every cell that is
+* not fixed. Fixed cells keep their value. Digits must be 0-9, otherwise a
+* runtime_error is thrown. Unlike setDigitAt, a digit of 0 (empty) is
+* allowed, so boards can be restored exactly from a compact copy.
+*/
+void Sudoku::setCells(const unsigned char* cells) {
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      // Check that digit is legal
+      if (cells[cell] > 9) {
+         throw runtime_error("Invalid domain for sudoku digit in setCells");
+      }
+
+      // Only change cells that are not fixed
+      if (!fixed_[cell / 9][cell % 9]) {
+         data_[cell / 9][cell % 9] = cells[cell];
+      }
+   }
+
+   // data_ was written directly, so rebuild the unit counts
+   countUnits();
+   fitnessDelta_ = 0;
+}
+
+/*
+* This method fills data_ and fixed_ from 81 digits 0-9 in row-major
+* order, just like readPuzzle but without going through an istream. Any
+* digit but zero is fixed. It is used by PuzzleCorpus to parse boards
+* straight out of a memory-mapped file.
+*/
+void Sudoku::loadCells(const unsigned char* cells) {
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      // Check that digit is legal
+      if (cells[cell] > 9) {
+         throw runtime_error("Invalid domain for sudoku digit in loadCells");
+      }
+
+      data_[cell / 9][cell % 9] = cells[cell];
+      fixed_[cell / 9][cell % 9] = cells[cell] != 0;
+   }
+
+   // data_ was written directly, so rebuild the unit counts
+   countUnits();
+   fitnessDelta_ = 0;
+}
+
+/*
+* This method returns true if the cell at row and col came from the
+* original puzzle and cannot be changed.
+*/
+bool Sudoku::isFixed(int row, int col) const {
    // Check bounds
    if (row < 0 || row >= 9 || col < 0 || col >= 9) {
-      throw runtime_error("Invalid bounds for setDigitAt");
+      throw runtime_error("Invalid bounds for isFixed");
    }
 
-   // Check that digit is legal
-   if (digit <= 0 || digit > 9) {
-      throw runtime_error("Invalid domain for sudoku digit in setDigitAt");
-   }
+   return fixed_[row][col];
+}
+
+/*
+* This method points the puzzle at 81 candidate masks (bit d set when
+* digit d may go in the cell), normally made by ConstraintPropagator.
+* The masks are not owned by the puzzle and must outlive it. nullptr means
+* any digit may go anywhere.
+*/
+void Sudoku::setCandidates(const unsigned short* candidates) {
+   candidates_ = candidates;
+}
+
+/*
+* This method returns the candidate masks of the puzzle, or nullptr if
+* there are none.
+*/
+const unsigned short* Sudoku::getCandidates() const {
+   return candidates_;
+}
+
+/*
+* This method returns how much the fitness score of this puzzle has changed
+* since it was copied (or since clearFitnessDelta was last called). It is
+* kept up to date by setDigitAt using the unitFreq_ table, so an offspring's
+* fitness is just its parent's score plus this value.
+*/
+int Sudoku::getFitnessDelta() const {
+   return fitnessDelta_;
+}
+
+/*
+* This method resets the fitness delta back to zero. It should be called
+* once the current score of the puzzle is known.
+*/
+void Sudoku::clearFitnessDelta() {
+   fitnessDelta_ = 0;
+}
+
+/*
+* This method returns the Zobrist hash of the digits on the board. Two
+* boards with the same digits always have the same hash. It is kept up to
+* date by setDigitAt with two XORs per changed cell.
+*/
+unsigned long long Sudoku::getHash() const {
+   return hash_;
+}
 
-   // Check if cell is fixed
-   if (fixed_[row][col]) {
-      return false; // Cannot be changed, return false
+/*
+* This helper method recounts unitFreq_ and hash_ from scratch using data_.
+* It is used whenever data_ is changed without going through setDigitAt.
+*/
+void Sudoku::countUnits() {
+   // Clear all of the counts
+   for (int unit = 0; unit < 27; unit++) {
+      for (int digit = 0; digit < 10; digit++) {
+         unitFreq_[unit][digit] = 0;
+      }
    }
 
-   data_[row][col] = digit;
-   return true;
+   // Count every cell once in its row, column and box
+   const int* cells = getCells();
+   hash_ = 0;
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      // Invariant: 0 <= i < 3
+      for (int i = 0; i < 3; i++) {
+         unitFreq_[SUDOKU_TABLES.cellUnits[cell][i]][cells[cell]]++;
+      }
+      hash_ ^= SUDOKU_TABLES.zobrist[cell][cells[cell]];
+   }
 }
\ No newline at end of file
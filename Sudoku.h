@@ -4,12 +4,18 @@
 * 3/6/2021
 * 
 * This class implements the Puzzle interface. It represents either a solved
-* or unsolved Puzzle solution. In the backend, it uses a 2d array of 81 ints
-* and bools to hold the data of the sudoku board.
+* or unsolved Puzzle solution. In the backend, it uses 2d arrays of 81 ints
+* and bools to hold the data of the sudoku board, plus the digit counts of
+* every row, column and box, a Zobrist hash and a pending fitness delta so
+* that a change can be scored without rescanning the board. That makes it
+* a working board: SudokuPopulation stores its boards as CompactSudoku and
+* only unpacks them into scratch Sudoku boards to make offspring.
 */
 
 #pragma once
 #include "Puzzle.h"
+#include "SudokuTables.h"
+#include <stdexcept>
 
 class Sudoku : public Puzzle
 {
@@ -26,6 +32,13 @@ public:
    */
    Sudoku(const Sudoku& other);
 
+   /*
+   * This assignment operator copies the data_ and fixed_ arrays from another
+   * sudoku object just like the copy constructor. It lets SudokuPopulation
+   * reuse puzzles that are already allocated instead of calling new.
+   */
+   Sudoku& operator=(const Sudoku& other);
+
    /*
    * This method is an implementation from the Puzzle interface. It accepts an
    * input stream and fills data_ and fixed_ with data values. It reads a stream
@@ -41,6 +54,13 @@ public:
    */
    ostream& writePuzzle(ostream& os) const;
 
+   /*
+   * This method writes the 81 digits of the puzzle in row-major order as
+   * characters '0'-'9' into out (no terminating null). It is the compact
+   * one-line format used by batch mode.
+   */
+   void writeCells(char* out) const;
+
    /*
    * This method returns the digit stored at row and col in the data_.
    */
@@ -49,11 +69,130 @@ public:
    /*
    * This method sets the digit in the puzzle at row and col to digit as long
    * as it is not fixed (check fixed_). If it is, it does nothing and returns
-   * false. If the change succeeds, return true.
+   * false. If the change succeeds, return true. It is defined in the header
+   * so it can be inlined into the mutation loops.
+   */
+   bool setDigitAt(int row, int col, int digit) {
+      // Check bounds
+      if (row < 0 || row >= 9 || col < 0 || col >= 9) {
+         throw runtime_error("Invalid bounds for setDigitAt");
+      }
+
+      // Check that digit is legal
+      if (digit <= 0 || digit > 9) {
+         throw runtime_error(
+            "Invalid domain for sudoku digit in setDigitAt");
+      }
+
+      // Check if cell is fixed
+      if (fixed_[row][col]) {
+         return false; // Cannot be changed, return false
+      }
+
+      // Update the unit counts and fitness delta if the digit changes
+      int old = data_[row][col];
+      if (old != digit) {
+         // Row, column and box units that contain the cell
+         const unsigned char* units = SUDOKU_TABLES.cellUnits[row * 9 + col];
+
+         // Invariant: 0 <= i < 3
+         for (int i = 0; i < 3; i++) {
+            unsigned char* freq = unitFreq_[units[i]];
+
+            // Removing a repeated digit removes one issue
+            if (freq[old] > 1) {
+               fitnessDelta_--;
+            }
+            freq[old]--;
+
+            // Adding a digit that is already in the unit adds one issue
+            if (freq[digit] > 0) {
+               fitnessDelta_++;
+            }
+            freq[digit]++;
+         }
+
+         // Swap the old digit's key for the new one in the hash
+         int cell = row * 9 + col;
+         hash_ ^= SUDOKU_TABLES.zobrist[cell][old];
+         hash_ ^= SUDOKU_TABLES.zobrist[cell][digit];
+      }
+
+      data_[row][col] = digit;
+      return true;
+   }
+
+   /*
+   * This method returns a pointer to the 81 digits of the puzzle stored in
+   * row-major order (cell = row * 9 + col). It does no bounds checking, so it
+   * is meant for the fitness kernels that use the tables in SudokuTables.h.
+   */
+   const int* getCells() const;
+
+   /*
+   * This method copies 81 digits (row-major order) into every cell that is
+   * not fixed. Fixed cells keep their value. Digits must be 0-9, otherwise a
+   * runtime_error is thrown. Unlike setDigitAt, a digit of 0 (empty) is
+   * allowed, so boards can be restored exactly from a compact copy.
+   */
+   void setCells(const unsigned char* cells);
+
+   /*
+   * This method fills data_ and fixed_ from 81 digits 0-9 in row-major
+   * order, just like readPuzzle but without going through an istream. Any
+   * digit but zero is fixed. It is used by PuzzleCorpus to parse boards
+   * straight out of a memory-mapped file.
+   */
+   void loadCells(const unsigned char* cells);
+
+   /*
+   * This method returns true if the cell at row and col came from the
+   * original puzzle and cannot be changed.
+   */
+   bool isFixed(int row, int col) const;
+
+   /*
+   * This method points the puzzle at 81 candidate masks (bit d set when
+   * digit d may go in the cell), normally made by ConstraintPropagator.
+   * The masks are not owned by the puzzle and must outlive it. nullptr means
+   * any digit may go anywhere.
+   */
+   void setCandidates(const unsigned short* candidates);
+
+   /*
+   * This method returns the candidate masks of the puzzle, or nullptr if
+   * there are none.
+   */
+   const unsigned short* getCandidates() const;
+
+   /*
+   * This method returns how much the fitness score of this puzzle has changed
+   * since it was copied (or since clearFitnessDelta was last called). It is
+   * kept up to date by setDigitAt using the unitFreq_ table, so an offspring's
+   * fitness is just its parent's score plus this value.
    */
-   bool setDigitAt(int row, int col, int digit);
+   int getFitnessDelta() const;
+
+   /*
+   * This method resets the fitness delta back to zero. It should be called
+   * once the current score of the puzzle is known.
+   */
+   void clearFitnessDelta();
+
+   /*
+   * This method returns the Zobrist hash of the digits on the board. Two
+   * boards with the same digits always have the same hash. It is kept up to
+   * date by setDigitAt with two XORs per changed cell.
+   */
+   unsigned long long getHash() const;
 
 private:
+   /*
+   * This helper method recounts unitFreq_ and hash_ from scratch using data_.
+   * It is used whenever data_ is changed without going through setDigitAt.
+   */
+   void countUnits();
+
    /*
    * This variable uses a 2d matrix to keep track of the digits being stored
    * in each cell of the sudoku puzzle.
@@ -66,5 +205,29 @@ private:
    * false value represents a cell that can be mutated.
    */
    bool fixed_[9][9];
+
+   /*
+   * This variable keeps track of how many times each digit 0-9 appears in
+   * each unit of the puzzle. Units 0-8 are rows, 9-17 are columns and 18-26
+   * are the 3x3 boxes (0=>topleft, 8=>bottomright).
+   */
+   unsigned char unitFreq_[27][10];
+
+   /*
+   * This variable holds the change in fitness score caused by setDigitAt
+   * since the puzzle was copied or the delta was last cleared.
+   */
+   int fitnessDelta_;
+
+   /*
+   * This variable holds the Zobrist hash of data_ (see SudokuTables.h).
+   */
+   unsigned long long hash_;
+
+   /*
+   * This variable points at the candidate masks shared by the population
+   * (see setCandidates), or is nullptr.
+   */
+   const unsigned short* candidates_;
 };
 
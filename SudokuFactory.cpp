@@ -10,6 +10,7 @@
 
 #include "SudokuFactory.h"
 #include "SudokuOffspring.h"
+#include "ConstraintPropagator.h"
 #include "Sudoku.h"
 
 /*
@@ -28,41 +29,96 @@ SudokuFactory& SudokuFactory::getInstance() {
 /*
 * This method is implemented from the PuzzleFactory interface. It
 * accepts a puzzle, casts it to a Sudoku, clones it, and then randomly
-* solves the clone using Sudoku#setDigitAt on every single cell.
-* Finally, it returns the new puzzle
+* solves the clone using Sudoku#setDigitAt on every single cell with
+* digits drawn from rng. Finally, it returns the new puzzle
 */
-Puzzle* SudokuFactory::fillPuzzle(const Puzzle& unsolved) const {
+Puzzle* SudokuFactory::fillPuzzle(const Puzzle& unsolved, Random& rng) const {
    // Cast puzzle to a sudoku
    Sudoku* sudoku = (Sudoku*) &unsolved;
 
    // Copy the puzzle using copy constructor
    Sudoku* copy = new Sudoku(*sudoku);
 
+   // Fill the copy in place
+   fillPuzzleInto(*copy, *copy, rng);
+
+   // Return the dynamically created sudoku (make sure its deleted)
+   return copy;
+}
+
+/*
+* This pure virtual method accepts a puzzle and then uses the
+* SudokuOffspring#makeOffspring method to return a new, mutated
+* sudoku puzzle.
+*/
+Puzzle* SudokuFactory::createPuzzle(const Puzzle& solved, Random& rng) const {
+   // Get instance of SudokuOffspring
+   SudokuOffspring& repro = SudokuOffspring::getInstance();
+
+   // Mutate it using SudokuOffspring
+   return repro.makeOffspring(solved, rng);
+}
+
+/*
+* This method does the same thing as fillPuzzle, but writes the randomly
+* solved copy into out instead of allocating a new puzzle. It is virtual
+* so other encodings (see PermutationFactory) can fill boards their own
+* way; fillPuzzle goes through it too.
+*/
+void SudokuFactory::fillPuzzleInto(const Sudoku& unsolved, Sudoku& out,
+   Random& rng) const {
+   // Copy the puzzle (skipped if they are the same puzzle)
+   if (&unsolved != &out) {
+      out = unsolved;
+   }
+
+   // Draw only from the candidates of each cell if there are any
+   const unsigned short* candidates = out.getCandidates();
+
    // Fill every number
    // Invariant: 0 < row < sudoku.data.length
    for (int row = 0; row < 9; row++) {
       // Invariant: 0 < col <= sudoku.data[row].length
       for (int col = 0; col < 9; col++) {
-         // Check if the number is <= 5 (5 percent chance)
+         // Fixed cells keep their digit and use no random numbers
+         if (candidates != nullptr && out.isFixed(row, col)) {
+            continue;
+         }
+
          // Try to change cell to random digit. If it's locked, it wont do anything.
-         int randDigit = rand() % 9 + 1;
-         copy->setDigitAt(row, col, randDigit);
+         int randDigit = candidates != nullptr
+            ? ConstraintPropagator::pickCandidate(candidates[row * 9 + col],
+               rng)
+            : rng.nextInt(9) + 1;
+         out.setDigitAt(row, col, randDigit);
       }
    }
+}
 
-   // Return the dynamically created sudoku (make sure its deleted)
-   return copy;
+/*
+* This method does the same thing as createPuzzle, but writes the mutated
+* copy into out instead of allocating a new puzzle, using mutationPercent
+* as the mutation rate. It is virtual for the same reason as
+* fillPuzzleInto.
+*/
+void SudokuFactory::createPuzzleInto(const Sudoku& solved, Sudoku& out,
+   Random& rng, int mutationPercent) const {
+   // Mutate it using SudokuOffspring
+   SudokuOffspring::getInstance().makeOffspringInto(solved, out, rng,
+      mutationPercent);
 }
 
 /*
-* This pure virtual method accepts a puzzle and then uses the
-* SudokuOffspring#makeOffspring method to return a new, mutated
-* sudoku puzzle.
+* This method is the two-parent version of createPuzzleInto. It writes a
+* crossover of mother and father (see SudokuOffspring#crossover) into out
+* and then mutates it. The fitness delta of out is relative to mother.
 */
-Puzzle* SudokuFactory::createPuzzle(const Puzzle& solved) const {
-   // Get instance of SudokuOffspring
-   SudokuOffspring repro = repro.getInstance();
+void SudokuFactory::crossPuzzleInto(const Sudoku& mother,
+   const Sudoku& father, Sudoku& out, Crossover kind, Random& rng,
+   int mutationPercent) const {
+   SudokuOffspring& repro = SudokuOffspring::getInstance();
 
-   // Mutate it using SudokuOffspring
-   return repro.makeOffspring(solved);
-}
\ No newline at end of file
+   // Combine the parents, then mutate the child in place
+   repro.crossoverInto(mother, father, out, kind, rng);
+   repro.makeOffspringInto(out, out, rng, mutationPercent);
+}
@@ -10,6 +10,8 @@
 
 #pragma once
 #include "PuzzleFactory.h"
+#include "Reproduction.h"
+#include "Sudoku.h"
 
 class SudokuFactory : public PuzzleFactory
 {
@@ -24,16 +26,42 @@ public:
    /*
    * This method is implemented from the PuzzleFactory interface. It
    * accepts a puzzle, casts it to a Sudoku, clones it, and then randomly
-   * solves the clone using Sudoku#setDigitAt on every single cell.
-   * Finally, it returns the new puzzle
+   * solves the clone using Sudoku#setDigitAt on every single cell with
+   * digits drawn from rng. Finally, it returns the new puzzle
    */
-   Puzzle* fillPuzzle(const Puzzle& unsolved) const;
+   Puzzle* fillPuzzle(const Puzzle& unsolved, Random& rng) const;
 
    /*
    * This pure virtual method accepts a puzzle and then uses the
    * SudokuOffspring#makeOffspring method to return a new, mutated
    * sudoku puzzle.
    */
-   Puzzle* createPuzzle(const Puzzle& solved) const;
+   Puzzle* createPuzzle(const Puzzle& solved, Random& rng) const;
+
+   /*
+   * This method does the same thing as fillPuzzle, but writes the randomly
+   * solved copy into out instead of allocating a new puzzle. It is virtual
+   * so other encodings (see PermutationFactory) can fill boards their own
+   * way; fillPuzzle goes through it too.
+   */
+   virtual void fillPuzzleInto(const Sudoku& unsolved, Sudoku& out,
+      Random& rng) const;
+
+   /*
+   * This method does the same thing as createPuzzle, but writes the mutated
+   * copy into out instead of allocating a new puzzle, using mutationPercent
+   * as the mutation rate. It is virtual for the same reason as
+   * fillPuzzleInto.
+   */
+   virtual void createPuzzleInto(const Sudoku& solved, Sudoku& out,
+      Random& rng, int mutationPercent) const;
+
+   /*
+   * This method is the two-parent version of createPuzzleInto. It writes a
+   * crossover of mother and father (see SudokuOffspring#crossover) into out
+   * and then mutates it. The fitness delta of out is relative to mother.
+   */
+   virtual void crossPuzzleInto(const Sudoku& mother, const Sudoku& father,
+      Sudoku& out, Crossover kind, Random& rng, int mutationPercent) const;
 };
 
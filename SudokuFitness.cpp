@@ -12,7 +12,9 @@
 * 328974613916238475743165982391827546274653198685491327867519234459382761132746858 => 6
 * 111111111111111111111111111111111111111111111111111111111111111111111111111111111 => 216
 * 000000000000000000000000000000000000000000000000000000000000000000000000000000000 => 216
-* 600002090000010802340000100000041600060000020009680000006000054703090000020500006
+* 600002090000010802340000100000041600060000020009680000006000054703090000020500006 => 138
+*
+* tests/FitnessTest.cpp checks howFit and howFitMask against these.
 */
 
 #include "SudokuFitness.h"
@@ -126,4 +128,35 @@ int SudokuFitness::howFit(const Puzzle& puzzle) {
    }
 
    return issues;
+}
+
+/*
+* This method returns the fitness of an offspring using the score of the
+* parent it was copied from. Instead of rescanning every unit, it adds the
+* fitness delta that Sudoku#setDigitAt tracked for the touched cells. If
+* check mode is on, the result is compared against howFit and a
+* runtime_error is thrown when they do not match.
+*/
+int SudokuFitness::howFitDelta(const Puzzle& offspring, int parentScore) {
+   // Cast puzzle to a sudoku
+   const Sudoku* sudoku = (const Sudoku*) &offspring;
+
+   // Parent score plus the change from the touched cells
+   int score = parentScore + sudoku->getFitnessDelta();
+
+   // Compare against a full scan if requested
+   if (checkMode_ && score != howFit(offspring)) {
+      throw runtime_error("Delta fitness does not match howFit");
+   }
+
+   return score;
+}
+
+/*
+* This method turns check mode on or off. Check mode makes howFitDelta
+* verify every result with a full howFit, which is slow but useful for
+* catching bookkeeping mistakes.
+*/
+void SudokuFitness::setCheckMode(bool check) {
+   checkMode_ = check;
 }
\ No newline at end of file
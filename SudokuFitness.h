@@ -10,6 +10,9 @@
 #pragma once
 #include "Fitness.h"
 #include "Puzzle.h"
+#include "CompactSudoku.h"
+#include "SudokuTables.h"
+#include <bitset>
 
 class SudokuFitness : public Fitness
 {
@@ -29,5 +32,78 @@ public:
    * it tallies them up and returns the number as the weight.
    */
    int howFit(const Puzzle& puzzle);
+
+   /*
+   * This method is a faster kernel that returns exactly the same score as
+   * howFit. It walks each of the 27 units using the compile-time tables in
+   * SudokuTables.h and ORs a bit for every digit (0-9) into a 16-bit mask.
+   * A unit of 9 cells with k distinct digits has 9 - k repeats, so the score
+   * of a unit is 9 - popcount(mask). No bounds-checked getDigitAt calls are
+   * made. It is virtual so that other encodings (see PermutationFitness)
+   * can score only the units they need to, and defined in the header so a
+   * call that names this class (as GeneticEngine makes) can be inlined.
+   */
+   virtual int howFitMask(const Puzzle& puzzle) const {
+      // Cast puzzle to a sudoku and score its raw cells
+      const Sudoku* sudoku = (const Sudoku*) &puzzle;
+      return maskKernel(sudoku->getCells());
+   }
+
+   /*
+   * This method runs the same kernel as howFitMask directly on the bytes of
+   * a CompactSudoku, so compact boards can be scored without unpacking them.
+   */
+   int howFitCompact(const CompactSudoku& board) const {
+      return maskKernel(board.getCells());
+   }
+
+   /*
+   * This method returns the fitness of an offspring using the score of the
+   * parent it was copied from. Instead of rescanning every unit, it adds the
+   * fitness delta that Sudoku#setDigitAt tracked for the touched cells. If
+   * check mode is on, the result is compared against howFit and a
+   * runtime_error is thrown when they do not match.
+   */
+   int howFitDelta(const Puzzle& offspring, int parentScore);
+
+   /*
+   * This method turns check mode on or off. Check mode makes howFitDelta
+   * verify every result with a full howFit, which is slow but useful for
+   * catching bookkeeping mistakes.
+   */
+   void setCheckMode(bool check);
+
+private:
+   /*
+   * This helper is the body of the mask kernel. It works on any array of 81
+   * digits in row-major order (ints for Sudoku, bytes for CompactSudoku).
+   */
+   template <typename Cell>
+   static int maskKernel(const Cell* cells) {
+      // Integer to keep track of issues in sudoku
+      int issues = 0;
+
+      // Invariant: 0 <= unit < 27
+      for (int unit = 0; unit < 27; unit++) {
+         const unsigned char* unitCells = SUDOKU_TABLES.unitCells[unit];
+
+         // Set one bit per distinct digit in the unit
+         unsigned short mask = 0;
+         // Invariant: 0 <= i < 9
+         for (int i = 0; i < 9; i++) {
+            mask |= (unsigned short)(1 << cells[unitCells[i]]);
+         }
+
+         // Every cell that did not add a new bit is a repeat
+         issues += 9 - (int) bitset<16>(mask).count();
+      }
+
+      return issues;
+   }
+
+   /*
+   * This field is true when howFitDelta should verify its results.
+   */
+   bool checkMode_ = false;
 };
 
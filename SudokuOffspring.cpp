@@ -9,8 +9,8 @@
 
 #include "SudokuOffspring.h"
 #include "Sudoku.h"
-
-const int MUTATION_PERCENT = 2;
+#include "SudokuTables.h"
+#include "ConstraintPropagator.h"
 
 /*
 * This singleton method returns the current instance of the class. Inside
@@ -27,32 +27,90 @@ SudokuOffspring& SudokuOffspring::getInstance() {
 
 /*
 * This method accepts a Puzzle object, casts it to a Sudoku, clones it using
-* a copy constructor, and then randomly changes 5% of the cells to a different
-* number 1-9. Then, it returns the cloned object.
+* a copy constructor, and then gives every cell a MUTATION_PERCENT in 100
+* chance of changing to a different number 1-9 drawn from rng. Then, it
+* returns the cloned object.
 */
-Puzzle* SudokuOffspring::makeOffspring(const Puzzle& puzzle) const {
+Puzzle* SudokuOffspring::makeOffspring(const Puzzle& puzzle,
+   Random& rng) const {
    // Case puzzle to a sudoku
    Sudoku* sudoku = (Sudoku*)&puzzle;
 
    // Clone it using a copy constructor
    Sudoku* copy = new Sudoku(*sudoku);
 
-   // 5% chance to change the cells to a different number 1-9
-   // Invariant: 0 < row < sudoku.data.length
-   for (int row = 0; row < 9; row++) {
-      // Invariant: 0 < col <= sudoku.data[row].length
-      for (int col = 0; col < 9; col++) {
-         // Random number from 0-99
-         int chance = rand() % 100;
-         // Check if the number is <= 5 (5 percent chance)
-         if (chance <= MUTATION_PERCENT) {
-            // Try to change cell to random digit. If it's locked, it wont work.
-            int randDigit = rand() % 9 + 1;
-            copy->setDigitAt(row, col, randDigit);
+   // Mutate the clone in place
+   makeOffspringInto(*copy, *copy, rng);
+
+   // Return copy
+   return copy;
+}
+
+/*
+* This method is implemented from the Reproduction interface. It clones
+* mother and then copies rows, boxes or single cells (depending on kind)
+* over from father, each with a 50% chance drawn from rng. Fixed cells
+* are skipped. The child is not mutated.
+*/
+Puzzle* SudokuOffspring::crossover(const Puzzle& mother, const Puzzle& father,
+   Crossover kind, Random& rng) const {
+   // Cast both parents to sudokus
+   const Sudoku* sudokuMother = (const Sudoku*) &mother;
+   const Sudoku* sudokuFather = (const Sudoku*) &father;
+
+   // Build the child in place in a clone of mother
+   Sudoku* child = new Sudoku(*sudokuMother);
+   crossoverInto(*child, *sudokuFather, *child, kind, rng);
+
+   return child;
+}
+
+/*
+* This method does the same thing as crossover, but writes the child into
+* a puzzle that already exists. The child's fitness delta is relative to
+* mother, so it can be scored from mother's score.
+*/
+void SudokuOffspring::crossoverInto(const Sudoku& mother,
+   const Sudoku& father, Sudoku& child, Crossover kind, Random& rng) const {
+   // Start from mother (skipped if they are the same puzzle)
+   if (&mother != &child) {
+      child = mother;
+   }
+
+   if (kind == NO_CROSSOVER) {
+      return;
+   }
+
+   if (kind == UNIFORM_CROSSOVER) {
+      // Every free cell comes from either parent
+      // Invariant: 0 <= cell < 81
+      for (int cell = 0; cell < 81; cell++) {
+         if (rng.nextInt(2) == 1 && !child.isFixed(cell / 9, cell % 9)) {
+            child.setDigitAt(cell / 9, cell % 9,
+               father.getDigitAt(cell / 9, cell % 9));
          }
       }
+      return;
    }
 
-   // Return copy
-   return copy;
-}
\ No newline at end of file
+   // Rows are units 0-8 and boxes are units 18-26 (see SudokuTables.h)
+   int firstUnit = kind == ROW_CROSSOVER ? 0 : 18;
+
+   // Invariant: 0 <= i < 9
+   for (int i = 0; i < 9; i++) {
+      // Half of the units come from father
+      if (rng.nextInt(2) == 0) {
+         continue;
+      }
+
+      const unsigned char* cells = SUDOKU_TABLES.unitCells[firstUnit + i];
+      // Invariant: 0 <= j < 9
+      for (int j = 0; j < 9; j++) {
+         int row = cells[j] / 9;
+         int col = cells[j] % 9;
+         if (!child.isFixed(row, col)) {
+            child.setDigitAt(row, col, father.getDigitAt(row, col));
+         }
+      }
+   }
+}
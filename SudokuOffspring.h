@@ -9,6 +9,8 @@
 
 #pragma once
 #include "Reproduction.h"
+#include "Sudoku.h"
+#include "ConstraintPropagator.h"
 
 class SudokuOffspring : public Reproduction
 {
@@ -20,11 +22,77 @@ public:
    */
    static SudokuOffspring& getInstance();
 
+   /*
+   * This is the default mutation rate. Each cell is changed when a random
+   * number from 0-99 is below the rate, so a rate of 0 never mutates.
+   */
+   static const int MUTATION_PERCENT = 2;
+
    /*
    * This method accepts a Puzzle object, casts it to a Sudoku, clones it using
-   * a copy constructor, and then randomly changes 5% of the cells to a different
-   * number 1-9. Then, it returns the cloned object.
+   * a copy constructor, and then gives every cell a MUTATION_PERCENT in 100
+   * chance of changing to a different number 1-9 drawn from rng. Then, it
+   * returns the cloned object.
+   */
+   Puzzle* makeOffspring(const Puzzle& puzzle, Random& rng) const;
+
+   /*
+   * This method does the same thing as makeOffspring, except that it copies
+   * parent into a puzzle that already exists instead of allocating a new
+   * one, and draws its random numbers from rng. It is used by
+   * SudokuPopulation, which gives every chunk of the population its own
+   * generator so chunks can be mutated on different threads.
+   * mutationPercent replaces MUTATION_PERCENT so the rate can be changed
+   * while the algorithm runs (see AdaptiveController). It is defined in
+   * the header so it can be inlined into the generation loops.
+   */
+   void makeOffspringInto(const Sudoku& parent, Sudoku& child, Random& rng,
+      int mutationPercent = MUTATION_PERCENT) const {
+      // Copy the parent into the child (skipped if they are the same puzzle)
+      if (&parent != &child) {
+         child = parent;
+      }
+
+      // Candidate masks from ConstraintPropagator (nullptr if none)
+      const unsigned short* candidates = child.getCandidates();
+
+      // mutationPercent in 100 chance to change each cell to a number 1-9
+      // Invariant: 0 < row < sudoku.data.length
+      for (int row = 0; row < 9; row++) {
+         // Invariant: 0 < col <= sudoku.data[row].length
+         for (int col = 0; col < 9; col++) {
+            // Random number from 0-99
+            int chance = rng.nextInt(100);
+            // Check if the number is below the rate (mutationPercent chance)
+            if (chance < mutationPercent) {
+               // Try to change cell to random digit. If it's locked, it
+               // wont work. With candidate masks, only digits that can go
+               // there are drawn.
+               int randDigit = candidates != nullptr
+                  ? ConstraintPropagator::pickCandidate(
+                     candidates[row * 9 + col], rng)
+                  : rng.nextInt(9) + 1;
+               child.setDigitAt(row, col, randDigit);
+            }
+         }
+      }
+   }
+
+   /*
+   * This method is implemented from the Reproduction interface. It clones
+   * mother and then copies rows, boxes or single cells (depending on kind)
+   * over from father, each with a 50% chance drawn from rng. Fixed cells
+   * are skipped. The child is not mutated.
+   */
+   Puzzle* crossover(const Puzzle& mother, const Puzzle& father,
+      Crossover kind, Random& rng) const;
+
+   /*
+   * This method does the same thing as crossover, but writes the child into
+   * a puzzle that already exists. The child's fitness delta is relative to
+   * mother, so it can be scored from mother's score.
    */
-   Puzzle* makeOffspring(const Puzzle& puzzle) const;
+   void crossoverInto(const Sudoku& mother, const Sudoku& father,
+      Sudoku& child, Crossover kind, Random& rng) const;
 };
 
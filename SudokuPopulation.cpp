@@ -3,35 +3,150 @@
 * Timothy Kozlov, Eric Pham
 *
 * This class implements the Population interface. It acts as a container
-* for Sudoku puzzle objects.
+* for Sudoku puzzles, stored as CompactSudoku boards (81 bytes each) that
+* share one FixedMask. Offspring are made in scratch Sudoku boards, one
+* set per chunk, which carry the unit counts that delta scoring needs.
 */
 
 #include "SudokuPopulation.h"
+#include "BufferedWriter.h"
+#include "Checkpoint.h"
 #include "SudokuFitness.h"
 #include "SudokuFactory.h"
+#include "SudokuOffspring.h"
+#include "PermutationFactory.h"
+#include "PermutationFitness.h"
+#include "TruncationSelection.h"
+#include "TournamentSelection.h"
+#include "RankSelection.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Number of times newGeneration remakes a duplicate offspring before
+// keeping it anyway (a board with almost every cell fixed may have no
+// other choice)
+const int MAX_DUPLICATE_RETRIES = 3;
+
+// Number of puzzles in a chunk unless setThreads says otherwise
+const int DEFAULT_CHUNK_SIZE = 1024;
+
+// Random streams used by restart and selection (the chunks use 1 and up,
+// duplicates use 0)
+const unsigned long long RESTART_STREAM = ~0ULL;
+const unsigned long long SELECTION_STREAM = ~1ULL;
 
 /*
 * The constructor will copy size into size_ and instantiates puzzles_
 * as a new vector. Then it will use SudokuFactory#fillPuzzle to add
 * several randomly-filled solutions based on original into the puzzles_
 * vector.
+*
+* Every random number the population uses comes from a stream derived from
+* seed, so the same seed (and chunk size) always gives the same run.
+*
+* If arena is true, every board lives in one of two slabs that are
+* allocated here, once. cull and newGeneration then reuse the slabs
+* instead of calling delete and new for each board.
+*
+* encoding picks the factory and fitness classes that are used for every
+* board of the population.
+*
+* If original has candidate masks (see ConstraintPropagator), the
+* population keeps its own copy of them and points every board at it.
 */
-SudokuPopulation::SudokuPopulation(Sudoku original, int size) {
-   // Get the SudokuFactory
-   SudokuFactory factory = factory.getInstance();
+SudokuPopulation::SudokuPopulation(Sudoku original, int size,
+   unsigned long long seed, bool arena, Encoding encoding) {
+   // Get the factory and fitness singletons for the encoding
+   if (encoding == PERMUTATION_ENCODING) {
+      factory_ = &PermutationFactory::getInstance();
+      fitness_ = &PermutationFitness::getInstance();
+   } else {
+      factory_ = &SudokuFactory::getInstance();
+      fitness_ = &SudokuFitness::getInstance();
+   }
+   encoding_ = encoding;
+   crossover_ = NO_CROSSOVER;
+   selection_ = &TruncationSelection::getInstance();
+   parents_ = new int[2 * size];
+   mutationPercent_ = SudokuOffspring::MUTATION_PERCENT;
+
+   // Copy the candidate masks so they live as long as the boards do
+   candidates_ = nullptr;
+   if (original.getCandidates() != nullptr) {
+      candidates_ = new unsigned short[81];
+      copy(original.getCandidates(), original.getCandidates() + 81,
+         candidates_);
+      original.setCandidates(candidates_);
+   }
+   original_ = original;
+   mask_ = FixedMask(original_);
+   best_ = original_;
 
    // Allocate size for array
    size_ = size;
    maxSize_ = size;
-   puzzles_ = new Sudoku*[size];
-
-   // Create size random versions of original
-   for (int i = 0; i < size; i++) {
-      // Copy and fill sudoku with random solution
-      Sudoku* copy = (Sudoku*)factory.fillPuzzle(original);
-      // Add it to the generation
-      puzzles_[i] = copy;
+   puzzles_ = new CompactSudoku*[size];
+   scores_ = new int[size];
+
+   // Scratch arrays used by cull, allocated once
+   order_ = new int[size];
+   sparePuzzles_ = new CompactSudoku*[size];
+   spareScores_ = new int[size];
+   bestIndex_ = 0;
+
+   // The cache and duplicate filter are turned on by their setters
+   cache_ = nullptr;
+   duplicates_ = nullptr;
+
+   // Run serially until setThreads is called
+   ownPool_ = new ThreadPool(1);
+   pool_ = ownPool_;
+   chunkSize_ = DEFAULT_CHUNK_SIZE;
+   chunkBest_ = new int[(size + chunkSize_ - 1) / chunkSize_ + 1];
+   chunkScoreNanos_ = new long long[(size + chunkSize_ - 1) / chunkSize_ + 1];
+   timeScoring_ = false;
+   hashes_ = nullptr;
+   scratch_ = nullptr;
+   makeScratch();
+
+   // Every generator is derived from this seed
+   seed_ = seed;
+   generation_ = 0;
+
+   // Allocate both generations up front in arena mode
+   slabs_[0] = arena ? new CompactSudoku[size] : nullptr;
+   slabs_[1] = arena ? new CompactSudoku[size] : nullptr;
+   currentSlab_ = 0;
+
+   // Create size random versions of original, one stream per chunk
+   int chunks = (size + chunkSize_ - 1) / chunkSize_;
+   for (int chunk = 0; chunk < chunks; chunk++) {
+      Random rng = Random::stream(seed_, generation_, chunk + 1);
+      Sudoku& scratch = scratch_[2 * chunk];
+      int end = min(size, (chunk + 1) * chunkSize_);
+
+      for (int i = chunk * chunkSize_; i < end; i++) {
+         // Fill a scratch board with a random solution and keep its digits
+         factory_->fillPuzzleInto(original_, scratch, rng);
+         CompactSudoku* board = arena ? &slabs_[0][i] : new CompactSudoku();
+         *board = CompactSudoku(scratch);
+         // Add it to the generation
+         puzzles_[i] = board;
+         // Score it once, later generations use the delta from this
+         scores_[i] = fitness_->howFitMask(scratch);
+         if (scores_[i] < scores_[bestIndex_]) {
+            bestIndex_ = i;
+         }
+      }
    }
 }
 
@@ -41,73 +156,87 @@ SudokuPopulation::SudokuPopulation(Sudoku original, int size) {
 * the program uses dynamic allocation, now it is.
 */
 SudokuPopulation::~SudokuPopulation() {
-   // Deallocate each pointer
-   for (int i = 0; i < size_; i++) {
-      //cout << "Deallocated a puzzle" << endl;
-      delete puzzles_[i];
+   if (slabs_[0] != nullptr) {
+      // Arena mode: the puzzles belong to the slabs
+      delete[] slabs_[0];
+      delete[] slabs_[1];
+   } else {
+      // Deallocate each pointer (boards replaced by cull are kept until
+      // newGeneration, so this covers all of them)
+      for (int i = 0; i < maxSize_; i++) {
+         //cout << "Deallocated a puzzle" << endl;
+         delete puzzles_[i];
+      }
    }
 
    delete[] puzzles_;
+   delete[] scores_;
+   delete[] order_;
+   delete[] sparePuzzles_;
+   delete[] spareScores_;
+   delete cache_;
+   delete duplicates_;
+   delete ownPool_;
+   delete[] chunkBest_;
+   delete[] chunkScoreNanos_;
+   delete[] hashes_;
+   delete[] candidates_;
+   delete[] parents_;
+   delete[] scratch_;
 }
 
 /*
-* This method is an implementation from the Population interface and
-* will calculate the fitness score of each element in the puzzles_ vector
-* using the SudokuFitness singleton and then remove the (size_ * percent)
-* elements with the worst (largest) fitness score. To do this, it will
-* use a for loop and vector#erase.
+* This method is an implementation from the Population interface. It is
+* the replacement step: it uses the fitness score of each element in the
+* puzzles_ vector (kept in scores_) to mark the (size_ * percent) elements
+* with the worst (largest) fitness score for replacement by the next
+* generation's offspring, and keeps the rest as they are. At least one
+* element is always replaced, so a percent of 0 replaces only the worst.
+* The marked elements are moved behind the survivors but not removed,
+* since selection picks parents from the whole scored population. To do
+* this, it uses nth_element over an index array, which takes linear
+* expected time.
 */
 void SudokuPopulation::cull(double percent) {
-   // Get SudokuFitness singleton
-   SudokuFitness fitness = fitness.getInstance();
-
    if (percent > 1) {
       throw runtime_error("Trying to cull more puzzles than there are.");
    }
 
-   // Create a dynamic array of fitness scores
-   int* scores = new int[size_];
+   // Calculate size after culling, replacing at least one puzzle
+   int newSize = max(0, min(size_ - 1, int(ceil(size_ * (1 - percent)))));
+
+   // Put the newSize best indices at the front of order_ in linear expected
+   // time. Ties are broken by index so the result never depends on the
+   // standard library's implementation.
    for (int i = 0; i < size_; i++) {
-      scores[i] = fitness.howFit(*puzzles_[i]);
+      order_[i] = i;
    }
-
-   // Calculate size after culling
-   int newSize = int(ceil(size_ * (1 - percent)));
-
-   // Delete scores with highest fitness
-   for (int i = 0; i < newSize; i++) {
-      
-      // Find the index with the lowest fitness score
-      int bestIndex = i;
-      for (int j = i + 1; j < size_; j++) {
-         if (scores[j] < scores[bestIndex]) {
-            bestIndex = j;
-         }
+   const int* scores = scores_;
+   nth_element(order_, order_ + newSize, order_ + size_,
+      [scores](int a, int b) {
+         return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+      });
+
+   // Gather survivors, then the puzzles to be replaced, into the spare
+   // arrays and track the best one. Puzzles replaced by an earlier cull
+   // stay where they are.
+   bestIndex_ = 0;
+   for (int i = 0; i < maxSize_; i++) {
+      int index = i < size_ ? order_[i] : i;
+      sparePuzzles_[i] = puzzles_[index];
+      spareScores_[i] = scores_[index];
+      if (spareScores_[i] < spareScores_[bestIndex_]) {
+         bestIndex_ = i;
       }
-
-      // Swap index i with best index in rest of array
-      Sudoku* tempPz = puzzles_[i];
-      puzzles_[i] = puzzles_[bestIndex];
-      puzzles_[bestIndex] = tempPz;
-
-      // Update parallel array scores
-      int tempScore = scores[i];
-      scores[i] = scores[bestIndex];
-      scores[bestIndex] = tempScore;
    }
 
-   // Clear rest of array
-   for (int i = newSize; i < size_; i++) {
-      delete puzzles_[i];
-      puzzles_[i] = nullptr;
-   }
+   // The spare arrays now hold the population, so swap them in
+   swap(puzzles_, sparePuzzles_);
+   swap(scores_, spareScores_);
 
    // Update size_ to newsize
    size_ = newSize;
 
-   // deallocate dynamic array
-   delete[] scores;
-
    /*cout << "after cull:" << endl;
    for (int i = 0; i < maxSize_; i++) {
       cout << (puzzles_[i] != nullptr ? fitness.howFit(*puzzles_[i]) : -1) << " ";
@@ -125,21 +254,149 @@ void SudokuPopulation::cull(double percent) {
 * puzzles_ vector with the new set we generated.
 */
 void SudokuPopulation::newGeneration() {
-   SudokuFactory creations = creations.getInstance();
+   // Each generation gets its own random streams
+   generation_++;
+
+   // In arena mode the next generation is built in the other slab
+   CompactSudoku* next = slabs_[1 - currentSlab_];
+
+   // Pick the parents of every offspring up front (two each with
+   // crossover) from the whole scored population, survivors first.
+   // order_ is free to use as scratch once cull is done.
+   int perChild = crossover_ != NO_CROSSOVER ? 2 : 1;
+   Random selectRng = Random::stream(seed_, generation_, SELECTION_STREAM);
+   selection_->select(scores_, maxSize_, size_, (maxSize_ - size_) * perChild,
+      parents_, order_, selectRng);
+
+   // The offspring replace puzzles that may be parents, so parents are read
+   // from the spare arrays (also free once cull is done)
+   copy(puzzles_, puzzles_ + maxSize_, sparePuzzles_);
+   copy(scores_, scores_ + maxSize_, spareScores_);
+
+   // Split the whole population into chunks. A chunk copies its survivors
+   // (arena mode only) and creates and scores its offspring using its own
+   // random stream and scratch boards, so the result does not depend on
+   // which thread runs it.
+   int chunks = (maxSize_ + chunkSize_ - 1) / chunkSize_;
+   auto makeChunk = [&](int chunk) {
+      Random rng = Random::stream(seed_, generation_, chunk + 1);
+      Sudoku& child = scratch_[2 * chunk];
+      Sudoku& other = scratch_[2 * chunk + 1];
+      int begin = chunk * chunkSize_;
+      int end = min(maxSize_, begin + chunkSize_);
+      int best = -1;
+      long long scoreNanos = 0;
+
+      for (int i = begin; i < end; i++) {
+         if (i < size_) {
+            // Copy the survivors over so that they keep their indices
+            if (next != nullptr) {
+               next[i] = *puzzles_[i];
+            }
+         } else {
+            // Use the parents that selection picked for this offspring
+            int j = parents_[(i - size_) * perChild];
+            int partner = parents_[(i - size_) * perChild + perChild - 1];
+
+            // Create a new puzzle from the one at j in a scratch board
+            makeChild(j, partner, child, other, rng);
+
+            // Score it from its parent using only the cells that changed
+            chrono::steady_clock::time_point start;
+            if (timeScoring_) {
+               start = chrono::steady_clock::now();
+            }
+            scores_[i] = scoreOffspring(child, spareScores_[j]);
+            if (timeScoring_) {
+               scoreNanos += chrono::duration_cast<chrono::nanoseconds>(
+                  chrono::steady_clock::now() - start).count();
+            }
+
+            // Keep only its digits
+            CompactSudoku* board = next != nullptr ? &next[i]
+               : new CompactSudoku();
+            *board = CompactSudoku(child);
+            puzzles_[i] = board;
+         }
+
+         // Remember the best puzzle of the chunk
+         if (best == -1 || scores_[i] < scores_[best]) {
+            best = i;
+         }
+      }
+
+      chunkBest_[chunk] = best;
+      chunkScoreNanos_[chunk] = scoreNanos;
+   };
+   pool_->parallelFor(chunks, makeChunk);
+   stats_.offspringCreated += maxSize_ - size_;
+   for (int chunk = 0; chunk < chunks; chunk++) {
+      stats_.scoreNanos += chunkScoreNanos_[chunk];
+   }
 
-   // This variable keeps track of puzzle we are cloning
-   int j = 0;
+   // Remake offspring that are already in this generation. This runs
+   // serially in index order with its own stream so it is reproducible.
+   if (duplicates_ != nullptr) {
+      Random rng = Random::stream(seed_, generation_, 0);
+      duplicates_->clear();
+
+      for (int i = 0; i < maxSize_; i++) {
+         // Survivors are always kept
+         CompactSudoku* puzzle = puzzles_[i];
+         unsigned long long hash = puzzle->getHash();
+         if (i < size_) {
+            duplicates_->insert(hash);
+            continue;
+         }
+
+         // Remake the puzzle a few times if it is already in this generation
+         int j = parents_[(i - size_) * perChild];
+         int partner = parents_[(i - size_) * perChild + perChild - 1];
+         int tries = 0;
+         while (!duplicates_->insert(hash) && tries < MAX_DUPLICATE_RETRIES) {
+            stats_.duplicatesRejected++;
+            makeChild(j, partner, scratch_[0], scratch_[1], rng);
+            scores_[i] = scoreOffspring(scratch_[0], spareScores_[j]);
+            *puzzle = CompactSudoku(scratch_[0]);
+            hash = scratch_[0].getHash();
+            tries++;
+         }
+
+         // Keep the chunk's best index correct after a remake
+         if (tries > 0) {
+            int chunk = i / chunkSize_;
+            if (scores_[i] < scores_[chunkBest_[chunk]]) {
+               chunkBest_[chunk] = i;
+            } else if (chunkBest_[chunk] == i) {
+               int end = min(maxSize_, (chunk + 1) * chunkSize_);
+               for (int k = chunk * chunkSize_; k < end; k++) {
+                  if (scores_[k] < scores_[chunkBest_[chunk]]) {
+                     chunkBest_[chunk] = k;
+                  }
+               }
+            }
+         }
+      }
+   }
 
-   for (int i = size_; i < maxSize_; i++) {
-      // Create a new puzzle using one at j
-      Sudoku* copy = (Sudoku*) creations.createPuzzle(*puzzles_[j]);
-      puzzles_[i] = copy;
+   // The best of the chunk bests (lowest index wins ties)
+   bestIndex_ = chunkBest_[0];
+   for (int chunk = 1; chunk < chunks; chunk++) {
+      if (scores_[chunkBest_[chunk]] < scores_[bestIndex_]) {
+         bestIndex_ = chunkBest_[chunk];
+      }
+   }
 
-      // If j moves out of bounds (previous generation portion at start
-      // of array), set it back to zero.
-      j++;
-      if (j >= size_) {
-         j = 0;
+   // Swap the slabs so the new generation becomes the current one, or
+   // free the replaced puzzles now that no offspring needs them
+   if (next != nullptr) {
+      for (int i = 0; i < size_; i++) {
+         puzzles_[i] = &next[i];
+      }
+      currentSlab_ = 1 - currentSlab_;
+   } else {
+      for (int i = size_; i < maxSize_; i++) {
+         delete sparePuzzles_[i];
       }
    }
 
@@ -156,8 +413,8 @@ void SudokuPopulation::newGeneration() {
 
 /*
 * This method is an implementation from the Population interface and uses
-* a loop and the SudokuFitness singleton to calculate and return the best
-* (lowest) fitness score encountered.
+* the best index tracked while scoring to return the best (lowest)
+* fitness score encountered in O(1).
 */
 int SudokuPopulation::bestFitness() const {
    // Get the best score
@@ -169,15 +426,580 @@ int SudokuPopulation::bestFitness() const {
 
 /*
 * This method is an implementation from the Population interface and uses
-* a loop and the SudokuFitness singleton to calculate and return the
-* puzzle with the best (lowest) fitness score.
+* the best index tracked while scoring to return the puzzle with the best
+* (lowest) fitness score in O(1). The best board is unpacked into a Sudoku
+* owned by the population, which stays valid until the next call or until
+* the population changes.
 */
 Puzzle* SudokuPopulation::bestIndividual() const {
    // Get the best index
    int bestIndex = bestPuzzle().first;
 
-   // Return dynamic copy of puzzle with best index (needs delete later)
-   return puzzles_[bestIndex];
+   // Unpack the best board into best_, which the population owns
+   puzzles_[bestIndex]->copyTo(best_);
+   return &best_;
+}
+
+/*
+* This method makes newGeneration run its chunks on pool, using chunks of
+* chunkSize puzzles. If pool is nullptr the chunks run serially on the
+* calling thread. The same seed and chunkSize give the same generations
+* for any number of threads.
+*/
+void SudokuPopulation::setThreads(ThreadPool* pool, int chunkSize) {
+   if (chunkSize < 1) {
+      throw runtime_error("Chunk size must be at least 1");
+   }
+
+   pool_ = pool != nullptr ? pool : ownPool_;
+   chunkSize_ = chunkSize;
+   makeScratch();
+
+   // Room for the best index of every chunk
+   delete[] chunkBest_;
+   delete[] chunkScoreNanos_;
+   chunkBest_ = new int[(maxSize_ + chunkSize_ - 1) / chunkSize_ + 1];
+   chunkScoreNanos_ = new long long[(maxSize_ + chunkSize_ - 1) / chunkSize_
+      + 1];
+}
+
+/*
+* This method turns on the fitness transposition table with room for the
+* given number of entries. Offspring are looked up by their Zobrist hash
+* before being scored. Passing 0 turns the table off.
+*/
+void SudokuPopulation::setFitnessCache(int entries) {
+   // Keep the counters of the old table
+   if (cache_ != nullptr) {
+      stats_.cacheLookups += cache_->getLookups();
+      stats_.cacheHits += cache_->getHits();
+   }
+   delete cache_;
+   cache_ = entries > 0 ? new FitnessCache(entries) : nullptr;
+}
+
+/*
+* This method turns duplicate rejection on or off. When it is on,
+* newGeneration remakes an offspring (up to a few times) if it is
+* identical to a board that is already in the new generation.
+*/
+void SudokuPopulation::setRejectDuplicates(bool reject) {
+   delete duplicates_;
+   duplicates_ = reject ? new DuplicateFilter(maxSize_) : nullptr;
+}
+
+/*
+* This method sets how newGeneration combines parents. With
+* NO_CROSSOVER (the default) every offspring is a mutated clone of one
+* parent. Otherwise each offspring is a crossover of two parents picked
+* by the selection strategy, which is then mutated.
+*/
+void SudokuPopulation::setCrossover(Crossover kind) {
+   crossover_ = kind;
+}
+
+/*
+* This method sets the strategy that picks which puzzles of the whole
+* scored population newGeneration makes each offspring from (see
+* Selection). The default is TRUNCATION_SELECTION, which gives every
+* survivor of cull the same number of children.
+*/
+void SudokuPopulation::setSelection(SelectionKind kind) {
+   if (kind == TOURNAMENT_SELECTION) {
+      selection_ = &TournamentSelection::getInstance();
+   } else if (kind == RANK_SELECTION) {
+      selection_ = &RankSelection::getInstance();
+   } else {
+      selection_ = &TruncationSelection::getInstance();
+   }
+}
+
+/*
+* This method sets the mutation rate used by newGeneration (see
+* SudokuOffspring#MUTATION_PERCENT, which is the default).
+*/
+void SudokuPopulation::setMutationPercent(int percent) {
+   mutationPercent_ = percent;
+}
+
+/*
+* This method returns the current mutation rate.
+*/
+int SudokuPopulation::getMutationPercent() const {
+   return mutationPercent_;
+}
+
+/*
+* This method returns the mean fitness score of the population.
+*/
+double SudokuPopulation::meanFitness() const {
+   if (size_ <= 0) {
+      return 0;
+   }
+   return accumulate(scores_, scores_ + size_, 0.0) / size_;
+}
+
+/*
+* This method returns the worst (highest) fitness score of the population.
+*/
+int SudokuPopulation::worstFitness() const {
+   if (size_ <= 0) {
+      return 0;
+   }
+   return *max_element(scores_, scores_ + size_);
+}
+
+/*
+* This method returns how different the boards of the population are,
+* from 0 (every board the same) to 1. For each cell that is not fixed it
+* takes the fraction of boards that do not hold the most common digit
+* there, and returns the mean over those cells. It takes O(81 * size).
+*/
+double SudokuPopulation::diversity() const {
+   // Count how many boards hold each digit (0-9) in each cell
+   int counts[81][10] = {};
+   for (int i = 0; i < size_; i++) {
+      const unsigned char* cells = puzzles_[i]->getCells();
+      // Invariant: 0 <= cell < 81
+      for (int cell = 0; cell < 81; cell++) {
+         counts[cell][cells[cell]]++;
+      }
+   }
+
+   // Average the share of boards that disagree with the majority
+   double total = 0;
+   int freeCells = 0;
+   for (int cell = 0; cell < 81; cell++) {
+      if (mask_.isFixed(cell)) {
+         continue;
+      }
+      int majority = *max_element(counts[cell], counts[cell] + 10);
+      total += 1 - (double) majority / size_;
+      freeCells++;
+   }
+
+   return freeCells > 0 && size_ > 0 ? total / freeCells : 0;
+}
+
+/*
+* This method returns how many boards are identical to another board
+* that comes earlier in the population (compared by Zobrist hash).
+*/
+int SudokuPopulation::countDuplicates() {
+   if (hashes_ == nullptr) {
+      hashes_ = new unsigned long long[maxSize_];
+   }
+
+   // Equal boards have equal hashes, which end up next to each other
+   for (int i = 0; i < size_; i++) {
+      hashes_[i] = puzzles_[i]->getHash();
+   }
+   sort(hashes_, hashes_ + size_);
+
+   int duplicates = 0;
+   for (int i = 1; i < size_; i++) {
+      if (hashes_[i] == hashes_[i - 1]) {
+         duplicates++;
+      }
+   }
+   return duplicates;
+}
+
+/*
+* This method turns timing of offspring scoring on or off. When it is on,
+* newGeneration adds the time spent scoring to
+* PopulationStats#scoreNanos. It is off by default since reading the
+* clock for every offspring costs a few percent.
+*/
+void SudokuPopulation::setTimeScoring(bool time) {
+   timeScoring_ = time;
+}
+
+/*
+* This method does a partial restart. The best (keepPercent * size)
+* puzzles (at least one) are kept and every other puzzle is refilled
+* from the original puzzle with the factory's fillPuzzleInto and
+* rescored. It is used when the population has stopped improving.
+*/
+void SudokuPopulation::restart(double keepPercent) {
+   int keep = max(1, min(size_, int(ceil(size_ * keepPercent))));
+
+   // Put the keep best indices first, ties broken by index
+   for (int i = 0; i < size_; i++) {
+      order_[i] = i;
+   }
+   const int* scores = scores_;
+   nth_element(order_, order_ + keep, order_ + size_,
+      [scores](int a, int b) {
+         return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+      });
+
+   stats_.restarts++;
+
+   // Refill the rest in place, so arena slabs are reused
+   Random rng = Random::stream(seed_, generation_, RESTART_STREAM);
+   Sudoku& scratch = scratch_[0];
+   for (int i = keep; i < size_; i++) {
+      int index = order_[i];
+      factory_->fillPuzzleInto(original_, scratch, rng);
+      *puzzles_[index] = CompactSudoku(scratch);
+      scores_[index] = fitness_->howFitMask(scratch);
+   }
+
+   // Find the best puzzle again (a refilled one may have beaten it)
+   bestIndex_ = 0;
+   for (int i = 0; i < size_; i++) {
+      if (scores_[i] < scores_[bestIndex_]) {
+         bestIndex_ = i;
+      }
+   }
+}
+
+/*
+* This method returns the counters collected so far.
+*/
+PopulationStats SudokuPopulation::getStats() const {
+   PopulationStats stats = stats_;
+
+   // The cache keeps its own counters, stats_ holds the ones from before
+   // it was made (an earlier table or a resumed checkpoint)
+   if (cache_ != nullptr) {
+      stats.cacheLookups += cache_->getLookups();
+      stats.cacheHits += cache_->getHits();
+   }
+
+   return stats;
+}
+
+/*
+* This method copies the count best puzzles (lowest scores) into out,
+* which must have room for count puzzles. It is used to pick migrants
+* in island mode. Returns how many were copied (at most the size of the
+* population).
+*/
+int SudokuPopulation::copyBest(int count, Sudoku* out) {
+   count = min(count, size_);
+
+   // Put the count best indices first, ties broken by index
+   for (int i = 0; i < size_; i++) {
+      order_[i] = i;
+   }
+   const int* scores = scores_;
+   nth_element(order_, order_ + count, order_ + size_,
+      [scores](int a, int b) {
+         return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+      });
+
+   for (int i = 0; i < count; i++) {
+      out[i] = original_;
+      puzzles_[order_[i]]->copyTo(out[i]);
+   }
+
+   return count;
+}
+
+/*
+* This method overwrites the count worst puzzles with the given boards
+* (which must come from the same original puzzle) and scores them. It is
+* used to take in migrants from another island.
+*/
+void SudokuPopulation::replaceWorst(const Sudoku* boards, int count) {
+   count = min(count, size_);
+
+   // Put the count worst indices first, ties broken by index
+   for (int i = 0; i < size_; i++) {
+      order_[i] = i;
+   }
+   const int* scores = scores_;
+   nth_element(order_, order_ + count, order_ + size_,
+      [scores](int a, int b) {
+         return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+      });
+
+   // Overwrite them in place so arena slabs are reused
+   bool lostBest = false;
+   for (int i = 0; i < count; i++) {
+      int index = order_[i];
+      *puzzles_[index] = CompactSudoku(boards[i]);
+      scores_[index] = fitness_->howFitMask(boards[i]);
+
+      if (index == bestIndex_) {
+         lostBest = true;
+      } else if (scores_[index] < scores_[bestIndex_]) {
+         bestIndex_ = index;
+      }
+   }
+
+   // Only possible if every puzzle had the same score, so just rescan
+   if (lostBest) {
+      for (int i = 0; i < size_; i++) {
+         if (scores_[i] < scores_[bestIndex_]) {
+            bestIndex_ = i;
+         }
+      }
+   }
+}
+
+/*
+* This method writes the population to a checkpoint file at path (see
+* Checkpoint.h), together with the state of the adaptive controller. The
+* file is written to path + ".tmp" first and then renamed, so a crash
+* while saving never leaves a broken checkpoint behind. It must be
+* called between generations (not after cull). Throws a runtime_error
+* if the file cannot be written.
+*/
+void SudokuPopulation::saveCheckpoint(const string& path,
+   const AdaptiveState& adaptive) const {
+   if (size_ != maxSize_) {
+      throw runtime_error("Cannot checkpoint a population that was culled");
+   }
+
+   CheckpointHeader header = {};
+   memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+   header.version = CHECKPOINT_VERSION;
+   header.boardCount = size_;
+   header.chunkSize = chunkSize_;
+   header.generation = generation_;
+   header.seed = seed_;
+   header.encoding = encoding_;
+   header.mutationPercent = mutationPercent_;
+   header.bestIndex = bestIndex_;
+   header.hasCandidates = candidates_ != nullptr;
+   header.stats = getStats();
+   header.adaptive = adaptive;
+
+   string temp = path + ".tmp";
+   FILE* file = fopen(temp.c_str(), "wb");
+   if (file == nullptr) {
+      throw runtime_error("Cannot write checkpoint " + temp);
+   }
+
+   // Scope the writer so it flushes before the file is closed
+   {
+      BufferedWriter out(file);
+      out.write((const char*) &header, sizeof(header));
+
+      // The original puzzle is the fixed mask, stored once
+      unsigned char digits[81];
+      const int* cells = original_.getCells();
+      for (int cell = 0; cell < 81; cell++) {
+         digits[cell] = (unsigned char) cells[cell];
+      }
+      out.write((const char*) digits, 81);
+      if (candidates_ != nullptr) {
+         out.write((const char*) candidates_, 81 * sizeof(unsigned short));
+      }
+
+      // Then every board, packed 4 bits per cell, in population order
+      unsigned char packed[CompactSudoku::PACKED_SIZE];
+      // Invariant: boards 0 to i - 1 have been written
+      for (int i = 0; i < size_; i++) {
+         puzzles_[i]->pack(packed);
+         out.write((const char*) packed, CompactSudoku::PACKED_SIZE);
+      }
+      out.write((const char*) scores_, size_ * sizeof(int));
+   }
+
+   bool failed = ferror(file) != 0;
+   if (fclose(file) != 0 || failed) {
+      remove(temp.c_str());
+      throw runtime_error("Cannot write checkpoint " + temp);
+   }
+   if (rename(temp.c_str(), path.c_str()) != 0) {
+      remove(temp.c_str());
+      throw runtime_error("Cannot rename checkpoint to " + path);
+   }
+}
+
+/*
+* This method replaces the boards, scores, seed, generation counter,
+* mutation rate and counters of the population with the ones saved in
+* the checkpoint at path, and stores the saved controller state in
+* adaptive. The file is memory-mapped and every board and score is
+* unpacked and checked (digits 0-9, fixed cells unchanged, scores not
+* negative) before any of the population is replaced, so a bad file
+* leaves it as it was. The population must have been built from the same
+* puzzle (after propagation), with the same size, encoding and chunk
+* size. Throws a runtime_error if the file cannot be read or does not
+* match.
+*/
+void SudokuPopulation::loadCheckpoint(const string& path,
+   AdaptiveState& adaptive) {
+   if (size_ != maxSize_) {
+      throw runtime_error("Cannot resume a population that was culled");
+   }
+
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd < 0) {
+      throw runtime_error("Cannot open checkpoint " + path);
+   }
+   struct stat info;
+   if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(
+      CheckpointHeader)) {
+      close(fd);
+      throw runtime_error(path + " is not a checkpoint");
+   }
+   size_t length = (size_t) info.st_size;
+   void* map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) {
+      throw runtime_error("Cannot map checkpoint " + path);
+   }
+   madvise(map, length, MADV_SEQUENTIAL);
+   const unsigned char* data = (const unsigned char*) map;
+
+   // Check everything before touching the population, so a bad file
+   // leaves it as it was
+   CheckpointHeader header;
+   memcpy(&header, data, sizeof(header));
+   string error;
+   size_t expected = sizeof(header) + 81 + (header.hasCandidates ? 81
+      * sizeof(unsigned short) : 0) + (size_t) header.boardCount
+      * (CompactSudoku::PACKED_SIZE + sizeof(int));
+   if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0
+      || header.version != CHECKPOINT_VERSION) {
+      error = path + " is not a checkpoint of this version";
+   } else if (header.boardCount != maxSize_ || length != expected) {
+      error = path + " holds " + to_string(header.boardCount)
+         + " boards, the population has " + to_string(maxSize_);
+   } else if (header.encoding != encoding_
+      || header.chunkSize != chunkSize_) {
+      error = path + " was saved with another encoding or chunk size";
+   } else if (header.bestIndex < 0 || header.bestIndex >= maxSize_) {
+      error = path + " is corrupt";
+   }
+
+   const unsigned char* digits = data + sizeof(header);
+   const unsigned char* next = digits + 81;
+   if (error.empty()) {
+      const int* cells = original_.getCells();
+      bool samePuzzle = true;
+      for (int cell = 0; cell < 81; cell++) {
+         samePuzzle = samePuzzle && digits[cell] == cells[cell];
+      }
+      if (header.hasCandidates) {
+         samePuzzle = samePuzzle && candidates_ != nullptr
+            && memcmp(next, candidates_, 81 * sizeof(unsigned short)) == 0;
+         next += 81 * sizeof(unsigned short);
+      } else {
+         samePuzzle = samePuzzle && candidates_ == nullptr;
+      }
+      if (!samePuzzle) {
+         error = path + " was saved for a different puzzle";
+      }
+   }
+   if (!error.empty()) {
+      munmap(map, length);
+      throw runtime_error(error);
+   }
+
+   // Unpack every board and score into temporary arrays first, so a
+   // corrupt board or score further on cannot leave the population half
+   // restored
+   vector<CompactSudoku> boards(maxSize_);
+   vector<int> scores(maxSize_);
+   memcpy(scores.data(), next + maxSize_ * CompactSudoku::PACKED_SIZE,
+      maxSize_ * sizeof(int));
+   // Invariant: boards 0 to i - 1 are valid and keep the fixed cells
+   for (int i = 0; i < maxSize_ && error.empty(); i++) {
+      bool valid = boards[i].unpack(next + i * CompactSudoku::PACKED_SIZE)
+         && scores[i] >= 0;
+      const unsigned char* cells = boards[i].getCells();
+      for (int cell = 0; cell < 81 && valid; cell++) {
+         valid = !mask_.isFixed(cell) || cells[cell] == digits[cell];
+      }
+      if (!valid) {
+         error = path + " is corrupt (board " + to_string(i) + ")";
+      }
+   }
+   munmap(map, length);
+   if (!error.empty()) {
+      throw runtime_error(error);
+   }
+
+   // Everything checked out, so replace the population
+   for (int i = 0; i < maxSize_; i++) {
+      *puzzles_[i] = boards[i];
+   }
+   memcpy(scores_, scores.data(), maxSize_ * sizeof(int));
+
+   // Every random stream follows from the seed and the generation
+   seed_ = header.seed;
+   generation_ = header.generation;
+   mutationPercent_ = header.mutationPercent;
+   bestIndex_ = header.bestIndex;
+   adaptive = header.adaptive;
+
+   // The saved counters include the cache's. getStats adds the current
+   // table's counters to stats_, so take off what it has counted already
+   stats_ = header.stats;
+   if (cache_ != nullptr) {
+      stats_.cacheLookups -= cache_->getLookups();
+      stats_.cacheHits -= cache_->getHits();
+   }
+}
+
+/*
+* This method returns the number of generations made so far.
+*/
+long long SudokuPopulation::getGeneration() const {
+   return generation_;
+}
+
+/*
+* This helper method returns the fitness score of an offspring. It checks
+* the fitness cache (if there is one) and otherwise scores the offspring
+* from its parent's score with SudokuFitness#howFitDelta (the same for
+* both encodings, since a swap inside a box never changes the box units).
+*/
+int SudokuPopulation::scoreOffspring(const Sudoku& child, int parentScore) {
+   int score;
+
+   // Boards that were seen before do not need to be scored again
+   if (cache_ != nullptr && cache_->lookup(child.getHash(), score)) {
+      return score;
+   }
+
+   score = fitness_->howFitDelta(child, parentScore);
+   if (cache_ != nullptr) {
+      cache_->store(child.getHash(), score);
+   }
+
+   return score;
+}
+
+/*
+* This helper method writes an offspring of the puzzle at index parent
+* of sparePuzzles_ (the population as it was scored) into child (a
+* scratch board), crossing it with the puzzle at index partner if
+* crossover is on, which is unpacked into the scratch board other. The
+* child's fitness delta is relative to the puzzle at index parent.
+*/
+void SudokuPopulation::makeChild(int parent, int partner, Sudoku& child,
+   Sudoku& other, Random& rng) const {
+   // Unpack the parent and change it in place
+   sparePuzzles_[parent]->copyTo(child);
+   if (crossover_ == NO_CROSSOVER) {
+      factory_->createPuzzleInto(child, child, rng, mutationPercent_);
+      return;
+   }
+
+   sparePuzzles_[partner]->copyTo(other);
+   factory_->crossPuzzleInto(child, other, child, crossover_, rng,
+      mutationPercent_);
+}
+
+/*
+* This helper method makes the scratch boards, two for every chunk, each
+* a copy of original_.
+*/
+void SudokuPopulation::makeScratch() {
+   int chunks = (maxSize_ + chunkSize_ - 1) / chunkSize_;
+   delete[] scratch_;
+   scratch_ = new Sudoku[2 * chunks];
+   for (int i = 0; i < 2 * chunks; i++) {
+      scratch_[i] = original_;
+   }
 }
 
 /*
@@ -193,25 +1015,6 @@ pair<int, int> SudokuPopulation::bestPuzzle() const {
       throw runtime_error("Tried to get best puzzle in empty population");
    }
 
-   // Get SudokuFitness singleton
-   SudokuFitness fitness = fitness.getInstance();
-
-   // Int to keep track of best score.
-   int bestScore = -1;
-   int bestIndex = -1;
-
-   // Use a for loop to calculate best score
-   for (int i = 0; i < size_; i++) {
-      // Calculate score of current puzzle
-      int score = fitness.howFit(*puzzles_[i]);
-
-      // If score is better, update it
-      if (bestScore == -1 || score < bestScore) {
-         bestScore = score;
-         bestIndex = i;
-      }
-   }
-
-   // Return pair of best index and best score
-   return make_pair(bestIndex, bestScore);
+   // bestIndex_ is kept up to date whenever a puzzle is scored
+   return make_pair(bestIndex_, scores_[bestIndex_]);
 }
@@ -3,13 +3,49 @@
 * Timothy Kozlov, Eric Pham
 * 
 * This class implements the Population interface. It acts as a container
-* for Sudoku puzzle objects.
+* for Sudoku puzzles, stored as CompactSudoku boards (81 bytes each) that
+* share one FixedMask. Offspring are made in scratch Sudoku boards, one
+* set per chunk, which carry the unit counts that delta scoring needs.
 */
 
 #pragma once
 #include <vector>
 #include "Population.h"
 #include "Sudoku.h"
+#include "CompactSudoku.h"
+#include "FitnessCache.h"
+#include "DuplicateFilter.h"
+#include "ThreadPool.h"
+#include "SudokuFactory.h"
+#include "SudokuFitness.h"
+#include "Selection.h"
+
+/*
+* This struct holds counters collected over a run, used to report how well
+* the fitness cache and the duplicate filter are working, how often the
+* population was restarted and how long scoring offspring took.
+*/
+struct PopulationStats {
+   long long offspringCreated = 0;
+   long long duplicatesRejected = 0;
+   long long cacheLookups = 0;
+   long long cacheHits = 0;
+   long long restarts = 0;
+   long long scoreNanos = 0;      // time spent scoring (see setTimeScoring)
+};
+
+/*
+* This enum picks how boards are filled, mutated and scored. CELL_ENCODING
+* is the original: every free cell gets a random digit and mutation
+* overwrites cells (SudokuFactory, SudokuOffspring, SudokuFitness).
+* PERMUTATION_ENCODING keeps every box a permutation of 1-9 and mutates by
+* swapping inside a box (PermutationFactory, PermutationOffspring,
+* PermutationFitness).
+*/
+enum Encoding { CELL_ENCODING, PERMUTATION_ENCODING };
+
+// Saved alongside the population in a checkpoint (see AdaptiveController.h)
+struct AdaptiveState;
 
 class SudokuPopulation : public Population
 {
@@ -19,8 +55,22 @@ public:
    * as a new vector. Then it will use SudokuFactory#fillPuzzle to add
    * several randomly-filled solutions based on original into the puzzles_
    * vector.
+   *
+   * Every random number the population uses comes from a stream derived from
+   * seed, so the same seed (and chunk size) always gives the same run.
+   *
+   * If arena is true, every board lives in one of two slabs that are
+   * allocated here, once. cull and newGeneration then reuse the slabs
+   * instead of calling delete and new for each board.
+   *
+   * encoding picks the factory and fitness classes that are used for every
+   * board of the population.
+   *
+   * If original has candidate masks (see ConstraintPropagator), the
+   * population keeps its own copy of them and points every board at it.
    */
-   SudokuPopulation(Sudoku original, int size);
+   SudokuPopulation(Sudoku original, int size, unsigned long long seed,
+      bool arena = false, Encoding encoding = CELL_ENCODING);
 
    /*
    * The destructor will loop through each puzzle in the puzzles_ vector
@@ -30,11 +80,16 @@ public:
    ~SudokuPopulation();
 
    /*
-   * This method is an implementation from the Population interface and
-   * will calculate the fitness score of each element in the puzzles_ vector
-   * using the SudokuFitness singleton and then remove the (size_ * percent)
-   * elements with the worst (largest) fitness score. To do this, it will
-   * use a for loop and vector#erase.
+   * This method is an implementation from the Population interface. It is
+   * the replacement step: it uses the fitness score of each element in the
+   * puzzles_ vector (kept in scores_) to mark the (size_ * percent) elements
+   * with the worst (largest) fitness score for replacement by the next
+   * generation's offspring, and keeps the rest as they are. At least one
+   * element is always replaced, so a percent of 0 replaces only the worst.
+   * The marked elements are moved behind the survivors but not removed,
+   * since selection picks parents from the whole scored population. To do
+   * this, it uses nth_element over an index array, which takes linear
+   * expected time.
    */
    void cull(double percent);
 
@@ -51,8 +106,8 @@ public:
 
    /*
    * This method is an implementation from the Population interface and uses
-   * a loop and the SudokuFitness singleton to calculate and return the best
-   * (lowest) fitness score encountered.
+   * the best index tracked while scoring to return the best (lowest)
+   * fitness score encountered in O(1).
    */
    int bestFitness() const;
 
@@ -61,11 +116,175 @@ public:
    * the best (lowest) fitness score. Pure virtual method -- implemented by child
    * class.
    *
-   * This class dynamically allocates the Puzzle copy
+   * The best board is unpacked into a Sudoku owned by the population, which
+   * stays valid until the next call or until the population changes.
    */
    Puzzle* bestIndividual() const;
 
+   /*
+   * This method makes newGeneration run its chunks on pool, using chunks of
+   * chunkSize puzzles. If pool is nullptr the chunks run serially on the
+   * calling thread. The same seed and chunkSize give the same generations
+   * for any number of threads.
+   */
+   void setThreads(ThreadPool* pool, int chunkSize);
+
+   /*
+   * This method turns on the fitness transposition table with room for the
+   * given number of entries. Offspring are looked up by their Zobrist hash
+   * before being scored. Passing 0 turns the table off.
+   */
+   void setFitnessCache(int entries);
+
+   /*
+   * This method turns duplicate rejection on or off. When it is on,
+   * newGeneration remakes an offspring (up to a few times) if it is
+   * identical to a board that is already in the new generation.
+   */
+   void setRejectDuplicates(bool reject);
+
+   /*
+   * This method sets how newGeneration combines parents. With
+   * NO_CROSSOVER (the default) every offspring is a mutated clone of one
+   * parent. Otherwise each offspring is a crossover of two parents picked
+   * by the selection strategy, which is then mutated.
+   */
+   void setCrossover(Crossover kind);
+
+   /*
+   * This method sets the strategy that picks which puzzles of the whole
+   * scored population newGeneration makes each offspring from (see
+   * Selection). The default is TRUNCATION_SELECTION, which gives every
+   * survivor of cull the same number of children.
+   */
+   void setSelection(SelectionKind kind);
+
+   /*
+   * This method sets the mutation rate used by newGeneration (see
+   * SudokuOffspring#MUTATION_PERCENT, which is the default).
+   */
+   void setMutationPercent(int percent);
+
+   /*
+   * This method returns the current mutation rate.
+   */
+   int getMutationPercent() const;
+
+   /*
+   * This method returns the mean fitness score of the population.
+   */
+   double meanFitness() const;
+
+   /*
+   * This method returns the worst (highest) fitness score of the population.
+   */
+   int worstFitness() const;
+
+   /*
+   * This method returns how different the boards of the population are,
+   * from 0 (every board the same) to 1. For each cell that is not fixed it
+   * takes the fraction of boards that do not hold the most common digit
+   * there, and returns the mean over those cells. It takes O(81 * size).
+   */
+   double diversity() const;
+
+   /*
+   * This method returns how many boards are identical to another board
+   * that comes earlier in the population (compared by Zobrist hash).
+   */
+   int countDuplicates();
+
+   /*
+   * This method turns timing of offspring scoring on or off. When it is on,
+   * newGeneration adds the time spent scoring to
+   * PopulationStats#scoreNanos. It is off by default since reading the
+   * clock for every offspring costs a few percent.
+   */
+   void setTimeScoring(bool time);
+
+   /*
+   * This method does a partial restart. The best (keepPercent * size)
+   * puzzles (at least one) are kept and every other puzzle is refilled
+   * from the original puzzle with the factory's fillPuzzleInto and
+   * rescored. It is used when the population has stopped improving.
+   */
+   void restart(double keepPercent);
+
+   /*
+   * This method returns the counters collected so far.
+   */
+   PopulationStats getStats() const;
+
+   /*
+   * This method copies the count best puzzles (lowest scores) into out,
+   * which must have room for count puzzles. It is used to pick migrants
+   * in island mode. Returns how many were copied (at most the size of the
+   * population).
+   */
+   int copyBest(int count, Sudoku* out);
+
+   /*
+   * This method overwrites the count worst puzzles with the given boards
+   * (which must come from the same original puzzle) and scores them. It is
+   * used to take in migrants from another island.
+   */
+   void replaceWorst(const Sudoku* boards, int count);
+
+   /*
+   * This method writes the population to a checkpoint file at path (see
+   * Checkpoint.h), together with the state of the adaptive controller. The
+   * file is written to path + ".tmp" first and then renamed, so a crash
+   * while saving never leaves a broken checkpoint behind. It must be
+   * called between generations (not after cull). Throws a runtime_error
+   * if the file cannot be written.
+   */
+   void saveCheckpoint(const string& path,
+      const AdaptiveState& adaptive) const;
+
+   /*
+   * This method replaces the boards, scores, seed, generation counter,
+   * mutation rate and counters of the population with the ones saved in
+   * the checkpoint at path, and stores the saved controller state in
+   * adaptive. The file is memory-mapped and every board and score is
+   * unpacked and checked (digits 0-9, fixed cells unchanged, scores not
+   * negative) before any of the population is replaced, so a bad file
+   * leaves it as it was. The population must have been built from the same
+   * puzzle (after propagation), with the same size, encoding and chunk
+   * size. Throws a runtime_error if the file cannot be read or does not
+   * match.
+   */
+   void loadCheckpoint(const string& path, AdaptiveState& adaptive);
+
+   /*
+   * This method returns the number of generations made so far.
+   */
+   long long getGeneration() const;
+
 private:
+   /*
+   * This helper method returns the fitness score of an offspring. It checks
+   * the fitness cache (if there is one) and otherwise scores the offspring
+   * from its parent's score with SudokuFitness#howFitDelta (the same for
+   * both encodings, since a swap inside a box never changes the box units).
+   */
+   int scoreOffspring(const Sudoku& child, int parentScore);
+
+   /*
+   * This helper method writes an offspring of the puzzle at index parent
+   * of sparePuzzles_ (the population as it was scored) into child (a
+   * scratch board), crossing it with the puzzle at index partner if
+   * crossover is on, which is unpacked into the scratch board other. The
+   * child's fitness delta is relative to the puzzle at index parent.
+   */
+   void makeChild(int parent, int partner, Sudoku& child, Sudoku& other,
+      Random& rng) const;
+
+   /*
+   * This helper method makes the scratch boards, two for every chunk, each
+   * a copy of original_.
+   */
+   void makeScratch();
+
    /*
    * This is a helper method to reduce the amount of redundant code. It is used
    * by both bestFitness and bestIndividual to calculate the puzzle with the least
@@ -76,9 +295,178 @@ private:
    pair<int, int> bestPuzzle() const;
 
    /*
-   * This field is a dynamic array of puzzle pointers.
+   * This field is a dynamic array of pointers to the boards.
+   */
+   CompactSudoku** puzzles_;
+
+   /*
+   * This field is a dynamic array parallel to puzzles_ that holds the fitness
+   * score of each puzzle. Offspring are scored from their parent's entry
+   * using SudokuFitness#howFitDelta, so no puzzle is ever fully rescanned.
+   */
+   int* scores_;
+
+   /*
+   * These fields are scratch arrays used by cull and newGeneration. order_
+   * holds indices into puzzles_ for cull, and the survivors are gathered
+   * into the spare arrays, which are then swapped with puzzles_ and
+   * scores_. newGeneration then reads the parents from a copy of the
+   * population in the spare arrays. They are allocated once so neither
+   * method allocates them.
+   */
+   int* order_;
+   CompactSudoku** sparePuzzles_;
+   int* spareScores_;
+
+   /*
+   * This field is the index in puzzles_ of the puzzle with the lowest score.
+   * It is updated whenever a puzzle is scored, so finding the best puzzle
+   * never needs a rescan.
+   */
+   int bestIndex_;
+
+   /*
+   * This field holds the two slabs of boards used by the arena storage
+   * mode (both nullptr otherwise). One slab holds the current generation
+   * and newGeneration builds the next one in the other, then they swap.
+   */
+   CompactSudoku* slabs_[2];
+
+   /*
+   * This field is the index (0 or 1) of the slab holding the current
+   * generation in arena mode.
+   */
+   int currentSlab_;
+
+   /*
+   * These fields are the factory that fills and mutates boards and the
+   * fitness class that scores them, picked by the encoding. Both are
+   * singletons.
+   */
+   const SudokuFactory* factory_;
+   SudokuFitness* fitness_;
+
+   /*
+   * This field is the encoding the factory and fitness class were picked
+   * for, saved in checkpoints.
+   */
+   Encoding encoding_;
+
+   /*
+   * This field is how offspring combine two parents (see setCrossover).
+   */
+   Crossover crossover_;
+
+   /*
+   * This field is the selection strategy (a singleton).
+   */
+   const Selection* selection_;
+
+   /*
+   * This field holds the parents picked by selection_ for the offspring of
+   * the generation being built (two per offspring with crossover).
+   */
+   int* parents_;
+
+   /*
+   * This field is the mutation rate passed to the factory.
+   */
+   int mutationPercent_;
+
+   /*
+   * This field is the puzzle the population was built from, kept so that
+   * restart can refill puzzles and scratch boards can be copied from it.
+   */
+   Sudoku original_;
+
+   /*
+   * This field holds which cells of original_ are fixed, shared by every
+   * board of the population.
+   */
+   FixedMask mask_;
+
+   /*
+   * This field holds the scratch boards, two for every chunk (the child
+   * and the crossover partner), so each chunk has its own while it runs.
+   */
+   Sudoku* scratch_;
+
+   /*
+   * This field is the best board, unpacked by bestIndividual.
+   */
+   mutable Sudoku best_;
+
+   /*
+   * This field is the population's copy of the candidate masks of the
+   * original puzzle, shared by every board (nullptr if it had none).
+   */
+   unsigned short* candidates_;
+
+   /*
+   * This field is the fitness transposition table (nullptr when off). It
+   * lasts across generations.
+   */
+   FitnessCache* cache_;
+
+   /*
+   * This field is the set of hashes in the generation being built, used to
+   * reject duplicates (nullptr when off).
+   */
+   DuplicateFilter* duplicates_;
+
+   /*
+   * This field holds the counters reported by getStats. Its cache counters
+   * only hold what was counted before cache_ was made (by an earlier table
+   * or a resumed run); getStats adds the ones cache_ keeps.
+   */
+   PopulationStats stats_;
+
+   /*
+   * These fields are the thread pool that runs the chunks of newGeneration
+   * and a one-thread pool owned by the population that is used when no
+   * other pool was given.
+   */
+   ThreadPool* pool_;
+   ThreadPool* ownPool_;
+
+   /*
+   * This field is the number of puzzles in each chunk.
+   */
+   int chunkSize_;
+
+   /*
+   * This field holds the index of the best puzzle in each chunk, which are
+   * combined into bestIndex_ after the chunks finish.
+   */
+   int* chunkBest_;
+
+   /*
+   * This field holds the scoring time of each chunk when timeScoring_ is
+   * on, which are added into stats_ after the chunks finish.
+   */
+   long long* chunkScoreNanos_;
+
+   /*
+   * This field is true when newGeneration times scoring.
+   */
+   bool timeScoring_;
+
+   /*
+   * This field is scratch space for the hashes compared by countDuplicates
+   * (nullptr until it is first called).
+   */
+   unsigned long long* hashes_;
+
+   /*
+   * This field is the seed that the random stream of every chunk is
+   * derived from (see Random#stream).
+   */
+   unsigned long long seed_;
+
+   /*
+   * This field counts generations so each one gets different streams.
    */
-   Sudoku** puzzles_;
+   long long generation_;
 
    /*
    * This field stores all the puzzles that are part of the current generation.
@@ -0,0 +1,95 @@
+/*
+* SudokuTables.h
+* Timothy Kozlov, Eric Pham
+*
+* This header builds lookup tables for the 9x9 sudoku board at compile time.
+* Cells are numbered 0-80 as row * 9 + col. Units are numbered 0-26, where
+* 0-8 are rows, 9-17 are columns and 18-26 are the 3x3 boxes (0=>topleft,
+* 8=>bottomright). The tables let the fitness kernels walk a unit or the
+* peers of a cell without doing any division or bounds checking. The
+* Zobrist keys used to hash boards are generated here too.
+*/
+
+#pragma once
+
+struct SudokuTables {
+   /*
+   * The 9 cells that make up each unit.
+   */
+   unsigned char unitCells[27][9];
+
+   /*
+   * The row, column and box unit that each cell belongs to.
+   */
+   unsigned char cellUnits[81][3];
+
+   /*
+   * The 20 other cells that share a row, column or box with each cell.
+   */
+   unsigned char cellPeers[81][20];
+
+   /*
+   * One random 64-bit key per cell and digit. The Zobrist hash of a board is
+   * the XOR of zobrist[cell][digit] over all of its cells, so changing one
+   * cell only needs two XORs to update the hash.
+   */
+   unsigned long long zobrist[81][10];
+};
+
+/*
+* This function fills in a SudokuTables struct. It is constexpr so that the
+* tables are computed by the compiler instead of at startup.
+*/
+constexpr SudokuTables makeSudokuTables() {
+   SudokuTables tables = {};
+
+   // State of the splitmix64 generator used for the Zobrist keys
+   unsigned long long state = 0x5D0CB7A3E1F29B47ULL;
+
+   // Invariant: 0 <= cell < 81
+   for (int cell = 0; cell < 81; cell++) {
+      int row = cell / 9;
+      int col = cell % 9;
+      int box = (row / 3) * 3 + col / 3;
+
+      // Each cell belongs to one row, column and box
+      tables.cellUnits[cell][0] = row;
+      tables.cellUnits[cell][1] = 9 + col;
+      tables.cellUnits[cell][2] = 18 + box;
+
+      // Position of the cell inside each of its units
+      tables.unitCells[row][col] = cell;
+      tables.unitCells[9 + col][row] = cell;
+      tables.unitCells[18 + box][(row % 3) * 3 + col % 3] = cell;
+
+      // Any other cell in the same row, column or box is a peer
+      int peers = 0;
+      // Invariant: 0 <= other < 81
+      for (int other = 0; other < 81; other++) {
+         int orow = other / 9;
+         int ocol = other % 9;
+         int obox = (orow / 3) * 3 + ocol / 3;
+         if (other != cell && (orow == row || ocol == col || obox == box)) {
+            tables.cellPeers[cell][peers] = other;
+            peers++;
+         }
+      }
+
+      // Give every digit of the cell its own random key (splitmix64)
+      // Invariant: 0 <= digit < 10
+      for (int digit = 0; digit < 10; digit++) {
+         state += 0x9E3779B97F4A7C15ULL;
+         unsigned long long z = state;
+         z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+         z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+         tables.zobrist[cell][digit] = z ^ (z >> 31);
+      }
+   }
+
+   return tables;
+}
+
+/*
+* The tables themselves. Every translation unit gets the same constant data.
+*/
+constexpr SudokuTables SUDOKU_TABLES = makeSudokuTables();
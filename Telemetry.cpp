@@ -0,0 +1,97 @@
+/*
+* Telemetry.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class writes one record per sampled generation of a run, so the
+* progress of the genetic algorithm can be plotted or compared afterwards.
+* Each record has the generation number, the best, mean and worst fitness,
+* the diversity of the population (see SudokuPopulation#diversity), the
+* number of duplicate boards and the milliseconds spent in cull,
+* newGeneration and scoring offspring during that generation. Scoring
+* time is added up over every chunk, so with several threads it can be
+* more than the time of newGeneration.
+*
+* Records are written as CSV (with a header line) or as JSON Lines (one
+* object per line). They go through a BufferedWriter, and only every
+* every-th generation is recorded, so that telemetry barely slows the loop.
+*/
+
+#include "Telemetry.h"
+#include <cstring>
+
+/*
+* The constructor writes records to file (which it does not own or
+* close) in the given format, one for every every-th generation.
+*/
+Telemetry::Telemetry(FILE* file, TelemetryFormat format, int every)
+   : writer_(file), format_(format), every_(every < 1 ? 1 : every),
+   wroteHeader_(false) {
+}
+
+/*
+* This method returns true if generation should be recorded. The first
+* generation is always recorded.
+*/
+bool Telemetry::isSampled(int generation) const {
+   return generation == 1 || generation % every_ == 0;
+}
+
+/*
+* This method writes the record of generation, reading the fitness
+* scores, diversity and duplicates from population.
+*/
+void Telemetry::record(int generation, SudokuPopulation& population,
+   const PhaseTimes& times) {
+   // Field names, shared by the CSV header and the JSON keys
+   static const char* const FIELDS[] = { "generation", "best", "mean",
+      "worst", "diversity", "duplicates", "cull_ms", "new_generation_ms",
+      "score_ms" };
+
+   if (format_ == CSV_TELEMETRY && !wroteHeader_) {
+      for (int i = 0; i < 9; i++) {
+         writer_.write(FIELDS[i], (int) strlen(FIELDS[i]));
+         writer_.write(i < 8 ? ',' : '\n');
+      }
+      wroteHeader_ = true;
+   }
+
+   // Every value is written as text so both formats share one loop
+   double values[9] = { (double) generation,
+      (double) population.bestFitness(), population.meanFitness(),
+      (double) population.worstFitness(), population.diversity(),
+      (double) population.countDuplicates(), times.cullSeconds * 1000,
+      times.newGenerationSeconds * 1000, times.scoreSeconds * 1000 };
+   // Digits after the decimal point of each field (0 for whole numbers)
+   static const int DECIMALS[] = { 0, 0, 3, 0, 4, 0, 3, 3, 3 };
+
+   if (format_ == JSONL_TELEMETRY) {
+      writer_.write('{');
+   }
+   // Invariant: 0 <= i < 9
+   for (int i = 0; i < 9; i++) {
+      if (format_ == JSONL_TELEMETRY) {
+         writer_.write('"');
+         writer_.write(FIELDS[i], (int) strlen(FIELDS[i]));
+         writer_.write("\":", 2);
+      }
+      if (DECIMALS[i] == 0) {
+         writer_.writeInt((long long) values[i]);
+      } else {
+         writer_.writeDouble(values[i], DECIMALS[i]);
+      }
+      if (i < 8) {
+         writer_.write(',');
+      }
+   }
+   if (format_ == JSONL_TELEMETRY) {
+      writer_.write('}');
+   }
+   writer_.write('\n');
+}
+
+/*
+* This method writes every buffered record out to the file.
+*/
+void Telemetry::flush() {
+   writer_.flush();
+}
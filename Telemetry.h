@@ -0,0 +1,85 @@
+/*
+* Telemetry.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class writes one record per sampled generation of a run, so the
+* progress of the genetic algorithm can be plotted or compared afterwards.
+* Each record has the generation number, the best, mean and worst fitness,
+* the diversity of the population (see SudokuPopulation#diversity), the
+* number of duplicate boards and the milliseconds spent in cull,
+* newGeneration and scoring offspring during that generation. Scoring
+* time is added up over every chunk, so with several threads it can be
+* more than the time of newGeneration.
+*
+* Records are written as CSV (with a header line) or as JSON Lines (one
+* object per line). They go through a BufferedWriter, and only every
+* every-th generation is recorded, so that telemetry barely slows the loop.
+*/
+
+#pragma once
+#include <cstdio>
+#include "BufferedWriter.h"
+#include "SudokuPopulation.h"
+
+/*
+* This enum picks the format of the records.
+*/
+enum TelemetryFormat { CSV_TELEMETRY, JSONL_TELEMETRY };
+
+/*
+* This struct holds the time spent in each phase of one generation.
+*/
+struct PhaseTimes {
+   double cullSeconds = 0;
+   double newGenerationSeconds = 0;
+   double scoreSeconds = 0;       // part of newGenerationSeconds
+};
+
+class Telemetry
+{
+public:
+   /*
+   * The constructor writes records to file (which it does not own or
+   * close) in the given format, one for every every-th generation.
+   */
+   Telemetry(FILE* file, TelemetryFormat format, int every);
+
+   /*
+   * This method returns true if generation should be recorded. The first
+   * generation is always recorded.
+   */
+   bool isSampled(int generation) const;
+
+   /*
+   * This method writes the record of generation, reading the fitness
+   * scores, diversity and duplicates from population.
+   */
+   void record(int generation, SudokuPopulation& population,
+      const PhaseTimes& times);
+
+   /*
+   * This method writes every buffered record out to the file.
+   */
+   void flush();
+
+private:
+   /*
+   * The writer that records are buffered in.
+   */
+   BufferedWriter writer_;
+
+   /*
+   * The format of the records.
+   */
+   TelemetryFormat format_;
+
+   /*
+   * Generations between records.
+   */
+   int every_;
+
+   /*
+   * This field is true once the CSV header has been written.
+   */
+   bool wroteHeader_;
+};
@@ -0,0 +1,148 @@
+/*
+* ThreadPool.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class keeps a fixed set of worker threads that are created once and
+* reused for every generation. parallelFor splits a job into numbered tasks
+* (one per chunk of the population) and runs them on the workers and on the
+* calling thread, then waits for all of them to finish. A pool with one
+* thread has no workers and simply runs every task on the caller. An
+* exception thrown by a task is caught on the thread that ran it and
+* thrown again by parallelFor on the calling thread.
+*/
+
+#include "ThreadPool.h"
+#include <stdexcept>
+
+/*
+* The constructor starts threads - 1 workers (the calling thread is the
+* last one). threads must be at least 1.
+*/
+ThreadPool::ThreadPool(int threads) : call_(nullptr), context_(nullptr),
+   tasks_(0), nextTask_(0), finished_(0), job_(0), active_(0),
+   stopping_(false) {
+   if (threads < 1) {
+      throw runtime_error("A thread pool needs at least one thread");
+   }
+
+   // The calling thread works too, so start one less worker
+   for (int i = 1; i < threads; i++) {
+      workers_.push_back(thread(&ThreadPool::workerLoop, this));
+   }
+}
+
+/*
+* The destructor tells every worker to stop and joins them.
+*/
+ThreadPool::~ThreadPool() {
+   {
+      lock_guard<mutex> lock(mutex_);
+      stopping_ = true;
+   }
+   wake_.notify_all();
+
+   for (thread& worker : workers_) {
+      worker.join();
+   }
+}
+
+/*
+* This method returns the number of threads that run tasks, including the
+* calling thread.
+*/
+int ThreadPool::getThreads() const {
+   return (int) workers_.size() + 1;
+}
+
+/*
+* This method publishes a job to the workers, helps run it and waits for
+* it to finish. Throws the first exception a task threw, if any.
+*/
+void ThreadPool::run(int tasks, void (*call)(void*, int), void* context) {
+   // Publish the job once no worker is still looking at the last one
+   {
+      unique_lock<mutex> lock(mutex_);
+      done_.wait(lock, [this] { return active_ == 0; });
+      call_ = call;
+      context_ = context;
+      tasks_ = tasks;
+      nextTask_.store(0);
+      finished_.store(0);
+      job_++;
+   }
+   wake_.notify_all();
+
+   // Help out, then wait for the tasks still running on workers
+   runTasks();
+
+   unique_lock<mutex> lock(mutex_);
+   done_.wait(lock, [this] {
+      return finished_.load() == tasks_ && active_ == 0;
+   });
+
+   // Hand a task's exception to the caller
+   if (error_) {
+      exception_ptr error = error_;
+      error_ = nullptr;
+      rethrow_exception(error);
+   }
+}
+
+/*
+* This method runs tasks of the current job until none are left. It is
+* used by both the workers and the calling thread.
+*/
+void ThreadPool::runTasks() {
+   int index = nextTask_.fetch_add(1);
+   while (index < tasks_) {
+      // Keep the first exception for run, which throws it on the caller
+      try {
+         call_(context_, index);
+      }
+      catch (...) {
+         lock_guard<mutex> lock(mutex_);
+         if (!error_) {
+            error_ = current_exception();
+         }
+      }
+
+      // The last task to finish wakes the caller
+      if (finished_.fetch_add(1) + 1 == tasks_) {
+         lock_guard<mutex> lock(mutex_);
+         done_.notify_all();
+      }
+
+      index = nextTask_.fetch_add(1);
+   }
+}
+
+/*
+* This method is the body of every worker thread.
+*/
+void ThreadPool::workerLoop() {
+   long long seen = 0;
+
+   while (true) {
+      // Sleep until there is a new job or the pool is stopping
+      {
+         unique_lock<mutex> lock(mutex_);
+         wake_.wait(lock, [this, seen] { return stopping_ || job_ != seen; });
+         if (stopping_) {
+            return;
+         }
+         seen = job_;
+         active_++;
+      }
+
+      runTasks();
+
+      // Let the caller know once every worker is idle again
+      {
+         lock_guard<mutex> lock(mutex_);
+         active_--;
+         if (active_ == 0) {
+            done_.notify_all();
+         }
+      }
+   }
+}
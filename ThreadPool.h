@@ -0,0 +1,131 @@
+/*
+* ThreadPool.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class keeps a fixed set of worker threads that are created once and
+* reused for every generation. parallelFor splits a job into numbered tasks
+* (one per chunk of the population) and runs them on the workers and on the
+* calling thread, then waits for all of them to finish. A pool with one
+* thread has no workers and simply runs every task on the caller. An
+* exception thrown by a task is caught on the thread that ran it and
+* thrown again by parallelFor on the calling thread.
+*/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class ThreadPool
+{
+public:
+   /*
+   * The constructor starts threads - 1 workers (the calling thread is the
+   * last one). threads must be at least 1.
+   */
+   explicit ThreadPool(int threads);
+
+   /*
+   * The destructor tells every worker to stop and joins them.
+   */
+   ~ThreadPool();
+
+   /*
+   * This method returns the number of threads that run tasks, including the
+   * calling thread.
+   */
+   int getThreads() const;
+
+   /*
+   * This method calls task(i) for every i in [0, tasks) spread over the
+   * threads of the pool and returns once all of them are done. Tasks are
+   * handed out in order but may finish in any order, so each task must only
+   * touch its own part of the data. task is passed by reference and type
+   * erased without allocating. If any task throws, the rest still run and
+   * then the first exception is thrown again here.
+   */
+   template <typename Task>
+   void parallelFor(int tasks, Task& task) {
+      run(tasks, &ThreadPool::invoke<Task>, &task);
+   }
+
+private:
+   /*
+   * This helper calls a task of type Task stored behind context.
+   */
+   template <typename Task>
+   static void invoke(void* context, int index) {
+      (*(Task*) context)(index);
+   }
+
+   /*
+   * This method publishes a job to the workers, helps run it and waits for
+   * it to finish. Throws the first exception a task threw, if any.
+   */
+   void run(int tasks, void (*call)(void*, int), void* context);
+
+   /*
+   * This method runs tasks of the current job until none are left. It is
+   * used by both the workers and the calling thread.
+   */
+   void runTasks();
+
+   /*
+   * This method is the body of every worker thread.
+   */
+   void workerLoop();
+
+   /*
+   * The worker threads.
+   */
+   vector<thread> workers_;
+
+   /*
+   * These fields describe the current job: the function to call, its
+   * context, the number of tasks and the next task to hand out.
+   */
+   void (*call_)(void*, int);
+   void* context_;
+   int tasks_;
+   atomic<int> nextTask_;
+
+   /*
+   * This field counts finished tasks of the current job.
+   */
+   atomic<int> finished_;
+
+   /*
+   * This field holds the first exception thrown by a task of the current
+   * job (guarded by mutex_).
+   */
+   exception_ptr error_;
+
+   /*
+   * This field is bumped for every job so workers can tell a new one apart
+   * from the last one.
+   */
+   long long job_;
+
+   /*
+   * This field counts workers that are inside runTasks. A new job is only
+   * published, and run only returns, once it is back to zero.
+   */
+   int active_;
+
+   /*
+   * This field is set by the destructor to stop the workers.
+   */
+   bool stopping_;
+
+   /*
+   * These fields guard the job fields and let workers sleep between jobs
+   * and the caller sleep until a job is finished and the workers are idle.
+   */
+   mutex mutex_;
+   condition_variable wake_;
+   condition_variable done_;
+};
@@ -0,0 +1,48 @@
+/*
+* TournamentSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface with tournaments. Each
+* parent is the best of TOURNAMENT_SIZE puzzles picked at random from the
+* whole population, so better puzzles get more children while weaker ones
+* still get some.
+*/
+
+#include "TournamentSelection.h"
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+TournamentSelection& TournamentSelection::getInstance() {
+   // Create a static instance
+   static TournamentSelection instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method is an implementation from the Selection interface. Each
+* parent is the puzzle with the lowest score out of TOURNAMENT_SIZE
+* random picks (ties go to the lower index). It takes
+* O(count * TOURNAMENT_SIZE) time.
+*/
+void TournamentSelection::select(const int* scores, int size,
+   int /*survivors*/, int count, int* parents, int* /*scratch*/,
+   Random& rng) const {
+   // Invariant: 0 <= i < count
+   for (int i = 0; i < count; i++) {
+      int winner = rng.nextInt(size);
+
+      // Invariant: 1 <= round < TOURNAMENT_SIZE
+      for (int round = 1; round < TOURNAMENT_SIZE; round++) {
+         int other = rng.nextInt(size);
+         if (scores[other] < scores[winner]
+            || (scores[other] == scores[winner] && other < winner)) {
+            winner = other;
+         }
+      }
+
+      parents[i] = winner;
+   }
+}
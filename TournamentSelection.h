@@ -0,0 +1,35 @@
+/*
+* TournamentSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface with tournaments. Each
+* parent is the best of TOURNAMENT_SIZE puzzles picked at random from the
+* whole population, so better puzzles get more children while weaker ones
+* still get some.
+*/
+
+#pragma once
+#include "Selection.h"
+
+class TournamentSelection : public Selection
+{
+public:
+   /*
+   * This is the number of puzzles that take part in each tournament.
+   */
+   static const int TOURNAMENT_SIZE = 3;
+
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static TournamentSelection& getInstance();
+
+   /*
+   * This method is an implementation from the Selection interface. Each
+   * parent is the puzzle with the lowest score out of TOURNAMENT_SIZE
+   * random picks (ties go to the lower index). It takes
+   * O(count * TOURNAMENT_SIZE) time.
+   */
+   void select(const int* scores, int size, int survivors, int count,
+      int* parents, int* scratch, Random& rng) const;
+};
@@ -0,0 +1,39 @@
+/*
+* TruncationSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface the way the program always
+* worked: only the survivors of cull (the best puzzles) are parents and
+* every survivor gets the same number of children, handed out
+* round-robin. Together with cull this is truncation selection with
+* elitism.
+*/
+
+#include "TruncationSelection.h"
+
+/*
+* This singleton method returns the current instance of the class.
+*/
+TruncationSelection& TruncationSelection::getInstance() {
+   // Create a static instance
+   static TruncationSelection instance;
+
+   // Return it
+   return instance;
+}
+
+/*
+* This method is an implementation from the Selection interface. It
+* picks the survivors round-robin (0, 1, ..., survivors - 1, 0, ...), or
+* the whole population if cull kept none, and uses no random numbers.
+*/
+void TruncationSelection::select(const int* /*scores*/, int size,
+   int survivors, int count, int* parents, int* /*scratch*/,
+   Random& /*rng*/) const {
+   int parentCount = survivors > 0 ? survivors : size;
+
+   // Invariant: 0 <= i < count
+   for (int i = 0; i < count; i++) {
+      parents[i] = i % parentCount;
+   }
+}
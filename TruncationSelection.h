@@ -0,0 +1,30 @@
+/*
+* TruncationSelection.h/cpp
+* Timothy Kozlov, Eric Pham
+*
+* This class implements the Selection interface the way the program always
+* worked: only the survivors of cull (the best puzzles) are parents and
+* every survivor gets the same number of children, handed out
+* round-robin. Together with cull this is truncation selection with
+* elitism.
+*/
+
+#pragma once
+#include "Selection.h"
+
+class TruncationSelection : public Selection
+{
+public:
+   /*
+   * This singleton method returns the current instance of the class.
+   */
+   static TruncationSelection& getInstance();
+
+   /*
+   * This method is an implementation from the Selection interface. It
+   * picks the survivors round-robin (0, 1, ..., survivors - 1, 0, ...), or
+   * the whole population if cull kept none, and uses no random numbers.
+   */
+   void select(const int* scores, int size, int survivors, int count,
+      int* parents, int* scratch, Random& rng) const;
+};
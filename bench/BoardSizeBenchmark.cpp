@@ -0,0 +1,210 @@
+/*
+* BoardSizeBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program checks that the 9x9 fast path does not slow down now that
+* larger boards are supported, and shows how the genetic algorithm scales
+* with the board size. It times scoring a board, making one offspring and
+* one whole generation (cull plus newGeneration) for:
+*    - sudoku:   the 9x9 Sudoku classes (arena storage), which
+*                solveBoard<3> uses
+*    - board<3>: the generic Board template at 9x9, for comparison
+*    - board<4>: a 16x16 board (bench/corpus/board16.txt)
+*    - board<5>: a 25x25 board (bench/corpus/board25.txt)
+* The 9x9 rows use the first puzzle of bench/corpus/hard.txt. The output is
+* CSV with one row per board:
+*
+*    board,cells,pop_size,ns_per_score,ns_per_offspring,ms_per_generation,
+*    ns_per_cell_generation
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/BoardSizeBenchmark.cpp -o boardsize
+* Usage (defaults shown):
+*    ./boardsize [popSize 1000] [generations 100]
+*/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Board.h"
+#include "BoardFitness.h"
+#include "BoardOffspring.h"
+#include "BoardPopulation.h"
+#include "PuzzleCorpus.h"
+#include "Random.h"
+#include "Sudoku.h"
+#include "SudokuFactory.h"
+#include "SudokuFitness.h"
+#include "SudokuOffspring.h"
+#include "SudokuPopulation.h"
+
+using namespace std;
+
+// Number of times each single-board operation is repeated
+const int BOARD_OPS = 200000;
+
+// Results are added into this so the compiler cannot skip the work
+static volatile long long sink = 0;
+
+/*
+* This helper returns the seconds taken by op().
+*/
+template <typename Op>
+static double seconds(Op op) {
+   auto start = chrono::steady_clock::now();
+   op();
+   chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+   return elapsed.count();
+}
+
+/*
+* This helper prints one CSV row.
+*/
+static void report(const string& name, int cells, int popSize,
+   double scoreSeconds, double offspringSeconds, double generationSeconds,
+   int generations) {
+   double perGeneration = generationSeconds / generations;
+   cout << name << "," << cells << "," << popSize << ","
+      << scoreSeconds * 1e9 / BOARD_OPS << ","
+      << offspringSeconds * 1e9 / BOARD_OPS << ","
+      << perGeneration * 1e3 << ","
+      << perGeneration * 1e9 / ((double) cells * popSize) << endl;
+}
+
+/*
+* This helper times the 9x9 Sudoku classes on puzzle.
+*/
+static void benchSudoku(const Sudoku& puzzle, int popSize, int generations) {
+   Random rng(343);
+   Sudoku board;
+   SudokuFactory::getInstance().fillPuzzleInto(puzzle, board, rng);
+   Sudoku child;
+
+   double score = seconds([&]() {
+      for (int i = 0; i < BOARD_OPS; i++) {
+         sink += SudokuFitness::getInstance().howFitMask(board);
+      }
+   });
+   double offspring = seconds([&]() {
+      for (int i = 0; i < BOARD_OPS; i++) {
+         SudokuOffspring::getInstance().makeOffspringInto(board, child, rng);
+         sink += child.getFitnessDelta();
+      }
+   });
+
+   SudokuPopulation pop(puzzle, popSize, 343, true);
+   double generation = seconds([&]() {
+      for (int i = 0; i < generations; i++) {
+         pop.cull(0.9);
+         pop.newGeneration();
+      }
+   });
+
+   report("sudoku", 81, popSize, score, offspring, generation, generations);
+}
+
+/*
+* This helper times the generic Board template on puzzle.
+*/
+template <int BOX>
+static void benchBoard(const Board<BOX>& puzzle, int popSize,
+   int generations) {
+   Random rng(343);
+   Board<BOX> board;
+   BoardFactory<BOX>::getInstance().fillPuzzleInto(puzzle, board, rng);
+   Board<BOX> child;
+
+   double score = seconds([&]() {
+      for (int i = 0; i < BOARD_OPS; i++) {
+         sink += BoardFitness<BOX>::getInstance().howFit(board);
+      }
+   });
+   double offspring = seconds([&]() {
+      for (int i = 0; i < BOARD_OPS; i++) {
+         BoardOffspring<BOX>::getInstance().makeOffspringInto(board, child,
+            rng);
+         sink += child.getFitnessDelta();
+      }
+   });
+
+   BoardPopulation<BOX> pop(puzzle, popSize, 343);
+   double generation = seconds([&]() {
+      for (int i = 0; i < generations; i++) {
+         pop.cull(0.9);
+         pop.newGeneration();
+      }
+   });
+
+   report("board<" + to_string(BOX) + ">", Board<BOX>::CELLS, popSize, score,
+      offspring, generation, generations);
+}
+
+/*
+* This helper reads a board from file. Throws a runtime_error if it cannot.
+*/
+template <int BOX>
+static Board<BOX> readBoard(const string& file) {
+   ifstream in(file);
+   if (!in) {
+      throw runtime_error("Cannot open " + file);
+   }
+   Board<BOX> board;
+   in >> board;
+   return board;
+}
+
+int main(int argc, char* argv[]) {
+   int popSize = 1000;
+   int generations = 100;
+   try {
+      if (argc > 1) {
+         popSize = stoi(argv[1]);
+      }
+      if (argc > 2) {
+         generations = stoi(argv[2]);
+      }
+   }
+   catch (exception&) {
+      cout << "Usage: " << argv[0] << " [popSize] [generations]" << endl;
+      return -1;
+   }
+   if (popSize < 1 || generations < 1) {
+      cout << "ERROR: Arguments must be positive." << endl;
+      return -1;
+   }
+
+   try {
+      // The same 9x9 puzzle for both 9x9 paths
+      PuzzleCorpus corpus("bench/corpus/hard.txt");
+      Sudoku sudoku;
+      long long line;
+      if (!corpus.next(sudoku, line)) {
+         throw runtime_error("bench/corpus/hard.txt has no puzzles");
+      }
+      const int* cells = sudoku.getCells();
+      unsigned char digits[81];
+      for (int cell = 0; cell < 81; cell++) {
+         digits[cell] = (unsigned char) cells[cell];
+      }
+      Board<3> board9;
+      board9.loadCells(digits);
+
+      Board<4> board16 = readBoard<4>("bench/corpus/board16.txt");
+      Board<5> board25 = readBoard<5>("bench/corpus/board25.txt");
+
+      cout << "board,cells,pop_size,ns_per_score,ns_per_offspring,"
+         << "ms_per_generation,ns_per_cell_generation" << endl;
+      benchSudoku(sudoku, popSize, generations);
+      benchBoard(board9, popSize, generations);
+      benchBoard(board16, popSize, generations);
+      benchBoard(board25, popSize, generations);
+   }
+   catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   return 0;
+}
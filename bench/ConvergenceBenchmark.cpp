@@ -0,0 +1,282 @@
+/*
+* ConvergenceBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program measures how fast the genetic algorithm converges, and
+* whether a change of settings really helps. A single run depends a lot
+* on its seed, so every puzzle of a corpus (see PuzzleCorpus) is solved
+* once for each of <seeds> seeds, and the runs are summarised:
+*    - how many runs solved their puzzle (success rate)
+*    - the mean, median and 90th percentile of the generations used
+*      (a run that did not solve its puzzle counts as the limit)
+*    - the mean, median and 90th percentile of the wall time of a run
+*
+* Solver flags (for example --cull 0.5 or --mutation 5) can follow the
+* numbers, and --pop N changes the population size. Everything after --vs
+* is a second configuration, which starts from the first one's settings.
+* When there are two, both run on the same puzzles and seeds (taking
+* turns, so that a busy machine slows both) and the differences are
+* tested:
+*    - generations and wall time with a two-sided Wilcoxon signed-rank
+*      test on the differences of each (puzzle, seed) pair, which does
+*      not assume the times are normally distributed
+*    - the success rate with a two-sided two-proportion z test
+* A small p value (below 0.05, say) means the difference is unlikely to be
+* caused by the seeds alone.
+*
+* The output is CSV: one summary row per configuration, then one row per
+* test.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/ConvergenceBenchmark.cpp -o convergence
+* Usage:
+*    ./convergence <corpus> <seeds> <popSize> <maxGenerations> [flags] \
+*       [--vs flags]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PuzzleCorpus.h"
+#include "Solver.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+/*
+* This struct holds the outcome of every run of one configuration.
+*/
+struct Runs {
+   vector<double> generations;
+   vector<double> milliseconds;
+   int solved = 0;
+};
+
+/*
+* This helper parses solver flags (and --pop) from argv[begin] up to, but
+* not including, argv[end] into options. Throws a runtime_error for a flag
+* it does not know.
+*/
+static void parseFlags(char* argv[], int begin, int end,
+   SolverOptions& options) {
+   for (int i = begin; i < end; i++) {
+      if (string(argv[i]) == "--pop" && i + 1 < end) {
+         options.popSize = stoi(argv[++i]);
+      } else if (!parseSolverFlag(end, argv, i, options)) {
+         throw runtime_error(string("Unknown flag ") + argv[i]);
+      }
+   }
+}
+
+/*
+* This helper returns the mean of values.
+*/
+static double mean(const vector<double>& values) {
+   double total = 0;
+   for (double value : values) {
+      total += value;
+   }
+   return values.empty() ? 0 : total / values.size();
+}
+
+/*
+* This helper returns the p-th quantile (0 <= p <= 1) of sorted using the
+* nearest rank, so it is always one of the values.
+*/
+static double quantile(const vector<double>& sorted, double p) {
+   if (sorted.empty()) {
+      return 0;
+   }
+   int rank = (int) ceil(p * sorted.size());
+   return sorted[max(0, rank - 1)];
+}
+
+/*
+* This helper returns the two-sided p value of a standard normal z score.
+*/
+static double twoSidedP(double z) {
+   return erfc(fabs(z) / sqrt(2.0));
+}
+
+/*
+* This helper runs a two-sided Wilcoxon signed-rank test on the paired
+* differences a[i] - b[i], using the normal approximation with a
+* correction for ties. Pairs with no difference are dropped. It stores
+* the rank sum of the positive differences and the z score and returns
+* the p value.
+*/
+static double wilcoxon(const vector<double>& a, const vector<double>& b,
+   double& w, double& z) {
+   // Rank the nonzero differences by size, ties get the mean of their ranks
+   vector<double> differences;
+   for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+      if (a[i] != b[i]) {
+         differences.push_back(a[i] - b[i]);
+      }
+   }
+   sort(differences.begin(), differences.end(),
+      [](double x, double y) { return fabs(x) < fabs(y); });
+
+   double n = (double) differences.size();
+   w = 0;
+   double tieTerm = 0;
+   // Invariant: every difference before i has been ranked
+   for (size_t i = 0; i < differences.size(); ) {
+      size_t j = i;
+      while (j < differences.size()
+         && fabs(differences[j]) == fabs(differences[i])) {
+         j++;
+      }
+      // Differences i..j-1 are tied and share the ranks i+1..j
+      double rank = (i + 1 + j) / 2.0;
+      for (size_t k = i; k < j; k++) {
+         if (differences[k] > 0) {
+            w += rank;
+         }
+      }
+      double t = (double) (j - i);
+      tieTerm += t * t * t - t;
+      i = j;
+   }
+
+   double variance = n * (n + 1) * (2 * n + 1) / 24 - tieTerm / 48;
+   z = variance > 0 ? (w - n * (n + 1) / 4) / sqrt(variance) : 0;
+   return variance > 0 ? twoSidedP(z) : 1;
+}
+
+/*
+* This helper prints the summary row of one configuration.
+*/
+static void summarise(const string& name, Runs runs) {
+   sort(runs.generations.begin(), runs.generations.end());
+   sort(runs.milliseconds.begin(), runs.milliseconds.end());
+   int count = (int) runs.generations.size();
+
+   cout << name << "," << count << "," << runs.solved << ","
+      << (double) runs.solved / count << ","
+      << mean(runs.generations) << ","
+      << quantile(runs.generations, 0.5) << ","
+      << quantile(runs.generations, 0.9) << ","
+      << mean(runs.milliseconds) << ","
+      << quantile(runs.milliseconds, 0.5) << ","
+      << quantile(runs.milliseconds, 0.9) << endl;
+}
+
+/*
+* This helper prints the Wilcoxon row comparing metric of a and b, whose
+* runs are paired by index. A negative z means a tends to be lower.
+*/
+static void compare(const string& metric, const vector<double>& a,
+   const vector<double>& b) {
+   double w, z;
+   double p = wilcoxon(a, b, w, z);
+   cout << metric << ",wilcoxon-signed-rank," << w << "," << z << "," << p
+      << endl;
+}
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 5) {
+      cout << "Usage: " << argv[0] << " <corpus> <seeds> <popSize> "
+         << "<maxGenerations> [flags] [--vs flags]" << endl;
+      return -1;
+   }
+
+   // The first configuration, and the second one if --vs is given
+   vector<SolverOptions> configs(1);
+   int seeds;
+   try {
+      seeds = stoi(argv[2]);
+      configs[0].popSize = stoi(argv[3]);
+      configs[0].maxGens = stoi(argv[4]);
+
+      int vs = 5;
+      while (vs < argc && string(argv[vs]) != "--vs") {
+         vs++;
+      }
+      parseFlags(argv, 5, vs, configs[0]);
+      if (vs < argc) {
+         configs.push_back(configs[0]);
+         parseFlags(argv, vs + 1, argc, configs[1]);
+      }
+   }
+   catch (exception& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+   if (seeds < 1) {
+      cout << "ERROR: Need at least one seed." << endl;
+      return -1;
+   }
+
+   // Read the whole corpus first so file access is not timed
+   vector<Sudoku> puzzles;
+   try {
+      PuzzleCorpus corpus(argv[1]);
+      Sudoku sudoku;
+      long long line;
+      while (corpus.next(sudoku, line)) {
+         puzzles.push_back(sudoku);
+      }
+   }
+   catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+   if (puzzles.empty()) {
+      cout << "ERROR: The corpus has no puzzles." << endl;
+      return -1;
+   }
+
+   // Every configuration solves every puzzle with every seed, taking turns
+   vector<Runs> runs(configs.size());
+   for (size_t p = 0; p < puzzles.size(); p++) {
+      for (int seed = 1; seed <= seeds; seed++) {
+         for (size_t c = 0; c < configs.size(); c++) {
+            SolverOptions options = configs[c];
+            options.seed = (unsigned long long) seed;
+
+            auto start = chrono::steady_clock::now();
+            SolveResult result = solve(puzzles[p], options);
+            chrono::duration<double, milli> elapsed =
+               chrono::steady_clock::now() - start;
+
+            runs[c].generations.push_back(result.generations);
+            runs[c].milliseconds.push_back(elapsed.count());
+            if (result.fitness == 0) {
+               runs[c].solved++;
+            }
+         }
+      }
+   }
+
+   cout << "config,runs,solved,success_rate,generations_mean,"
+      << "generations_median,generations_p90,ms_mean,ms_median,ms_p90"
+      << endl;
+   summarise("a", runs[0]);
+   if (configs.size() == 1) {
+      return 0;
+   }
+   summarise("b", runs[1]);
+
+   // Tests of a against b
+   cout << endl << "metric,test,statistic,z,p_value" << endl;
+   compare("generations", runs[0].generations, runs[1].generations);
+   compare("ms", runs[0].milliseconds, runs[1].milliseconds);
+
+   // Two-proportion z test with the pooled success rate
+   double n = (double) runs[0].generations.size();
+   double rateA = runs[0].solved / n;
+   double rateB = runs[1].solved / n;
+   double pooled = (runs[0].solved + runs[1].solved) / (2 * n);
+   double spread = sqrt(pooled * (1 - pooled) * 2 / n);
+   double z = spread > 0 ? (rateA - rateB) / spread : 0;
+   cout << "success_rate,two-proportion-z," << rateA - rateB << "," << z
+      << "," << (spread > 0 ? twoSidedP(z) : 1) << endl;
+
+   return 0;
+}
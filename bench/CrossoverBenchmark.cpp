@@ -0,0 +1,103 @@
+/*
+* CrossoverBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program measures how crossover changes convergence speed. Every
+* puzzle of a corpus (see PuzzleCorpus) is solved once with each crossover
+* kind (none, row, box and uniform) using the same seed, and one summary
+* row is printed per kind: how many puzzles were solved, the median
+* generations used (unsolved puzzles count as the limit), the mean best
+* fitness and the mean time per puzzle. Any solver flag (for example
+* --encoding permutation) can be given after the numbers.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/CrossoverBenchmark.cpp -o crossover
+* Usage:
+*    ./crossover <corpus> <popSize> <maxGenerations> [solver flags]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PuzzleCorpus.h"
+#include "Solver.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 4) {
+      cout << "Usage: " << argv[0]
+         << " <corpus> <popSize> <maxGenerations> [solver flags]" << endl;
+      return -1;
+   }
+
+   SolverOptions options;
+   options.seed = 343;
+   vector<Sudoku> puzzles;
+   try {
+      options.popSize = stoi(argv[2]);
+      options.maxGens = stoi(argv[3]);
+
+      // Any other solver settings
+      for (int i = 4; i < argc; i++) {
+         if (!parseSolverFlag(argc, argv, i, options)) {
+            throw runtime_error(string("Unknown flag ") + argv[i]);
+         }
+      }
+
+      // Read the whole corpus up front
+      PuzzleCorpus corpus(argv[1]);
+      Sudoku sudoku;
+      long long line;
+      while (corpus.next(sudoku, line)) {
+         puzzles.push_back(sudoku);
+      }
+   }
+   catch (exception& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   if (puzzles.empty()) {
+      cout << "ERROR: The corpus has no puzzles." << endl;
+      return -1;
+   }
+
+   const Crossover kinds[4] = { NO_CROSSOVER, ROW_CROSSOVER, BOX_CROSSOVER,
+      UNIFORM_CROSSOVER };
+   const char* names[4] = { "none", "row", "box", "uniform" };
+
+   cout << "crossover,puzzles,solved,median_generations,mean_fitness,"
+      << "mean_seconds" << endl;
+
+   for (int k = 0; k < 4; k++) {
+      options.crossover = kinds[k];
+      vector<int> generations;
+      int solved = 0;
+      double fitness = 0;
+
+      auto start = chrono::steady_clock::now();
+      for (const Sudoku& puzzle : puzzles) {
+         SolveResult result = solve(puzzle, options);
+         generations.push_back(result.generations);
+         fitness += result.fitness;
+         if (result.fitness == 0) {
+            solved++;
+         }
+      }
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+      sort(generations.begin(), generations.end());
+      cout << names[k] << "," << puzzles.size() << "," << solved << ","
+         << generations[generations.size() / 2] << ","
+         << fitness / puzzles.size() << ","
+         << elapsed.count() / puzzles.size() << endl;
+   }
+
+   return 0;
+}
@@ -0,0 +1,101 @@
+/*
+* EncodingBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program compares the cell encoding (random digits, overwrite
+* mutation) with the permutation encoding (box permutations, swap mutation)
+* on one puzzle. Each encoding is run once per seed until the puzzle is
+* solved or the generation limit is reached. It prints one CSV row per run
+* and then a summary row per encoding with how many runs solved the puzzle
+* and the median generations to solve (unsolved runs count as the limit).
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/EncodingBenchmark.cpp -o encoding
+* Usage:
+*    ./encoding <seeds> <popSize> <maxGenerations> < puzzle.txt
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Solver.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 4) {
+      cout << "Usage: " << argv[0]
+         << " <seeds> <popSize> <maxGenerations>" << endl;
+      return -1;
+   }
+
+   SolverOptions options;
+   int seeds;
+   try {
+      seeds = stoi(argv[1]);
+      options.popSize = stoi(argv[2]);
+      options.maxGens = stoi(argv[3]);
+   }
+   catch (exception&) {
+      cout << "ERROR: Invalid arguments provided." << endl;
+      return -1;
+   }
+   if (seeds < 1) {
+      cout << "ERROR: Need at least one seed." << endl;
+      return -1;
+   }
+
+   Sudoku sudoku;
+   try {
+      cin >> sudoku;
+   } catch (runtime_error&) {
+      cout << "ERROR: Invalid sudoku input" << endl;
+      return -1;
+   }
+
+   const Encoding encodings[2] = { CELL_ENCODING, PERMUTATION_ENCODING };
+   const char* names[2] = { "cells", "permutation" };
+   vector<int> generations[2];
+   int solved[2] = { 0, 0 };
+   double seconds[2] = { 0, 0 };
+
+   cout << "encoding,seed,generations,best_fitness,seconds" << endl;
+
+   // Both encodings get the same seeds
+   for (int seed = 1; seed <= seeds; seed++) {
+      for (int e = 0; e < 2; e++) {
+         options.encoding = encodings[e];
+         options.seed = seed;
+
+         auto start = chrono::steady_clock::now();
+         SolveResult result = solve(sudoku, options);
+         chrono::duration<double> elapsed =
+            chrono::steady_clock::now() - start;
+
+         generations[e].push_back(result.generations);
+         seconds[e] += elapsed.count();
+         if (result.fitness == 0) {
+            solved[e]++;
+         }
+
+         cout << names[e] << "," << seed << "," << result.generations << ","
+            << result.fitness << "," << elapsed.count() << endl;
+      }
+   }
+
+   cout << endl << "encoding,runs,solved,median_generations,mean_seconds"
+      << endl;
+   for (int e = 0; e < 2; e++) {
+      sort(generations[e].begin(), generations[e].end());
+      cout << names[e] << "," << seeds << "," << solved[e] << ","
+         << generations[e][generations[e].size() / 2] << ","
+         << seconds[e] / seeds << endl;
+   }
+
+   return 0;
+}
@@ -0,0 +1,103 @@
+/*
+* EngineBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program compares the genetic algorithm with the exact engine (see
+* ExactSolver) on the same corpus (see PuzzleCorpus). Every puzzle is
+* solved once by each engine and one summary row is printed per engine:
+* how many puzzles were solved, the success rate and the mean, median and
+* 99th percentile time per puzzle. Any solver flag (for example --threads
+* or --encoding) can be given after the numbers and applies to the GA.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/EngineBenchmark.cpp -o engine
+* Usage:
+*    ./engine <corpus> <popSize> <maxGenerations> [solver flags]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PuzzleCorpus.h"
+#include "Solver.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 4) {
+      cout << "Usage: " << argv[0]
+         << " <corpus> <popSize> <maxGenerations> [solver flags]" << endl;
+      return -1;
+   }
+
+   SolverOptions options;
+   options.seed = 343;
+   vector<Sudoku> puzzles;
+   try {
+      options.popSize = stoi(argv[2]);
+      options.maxGens = stoi(argv[3]);
+
+      // Any other solver settings
+      for (int i = 4; i < argc; i++) {
+         if (!parseSolverFlag(argc, argv, i, options)) {
+            throw runtime_error(string("Unknown flag ") + argv[i]);
+         }
+      }
+
+      // Read the whole corpus up front
+      PuzzleCorpus corpus(argv[1]);
+      Sudoku sudoku;
+      long long line;
+      while (corpus.next(sudoku, line)) {
+         puzzles.push_back(sudoku);
+      }
+   }
+   catch (exception& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   if (puzzles.empty()) {
+      cout << "ERROR: The corpus has no puzzles." << endl;
+      return -1;
+   }
+
+   const Engine engines[2] = { GA_ENGINE, EXACT_ENGINE };
+   const char* names[2] = { "ga", "exact" };
+
+   cout << "engine,puzzles,solved,success_rate,mean_ms,p50_ms,p99_ms" << endl;
+
+   for (int e = 0; e < 2; e++) {
+      options.engine = engines[e];
+      vector<double> times;
+      int solved = 0;
+      double total = 0;
+
+      for (const Sudoku& puzzle : puzzles) {
+         auto start = chrono::steady_clock::now();
+         SolveResult result = solve(puzzle, options);
+         chrono::duration<double, milli> elapsed =
+            chrono::steady_clock::now() - start;
+
+         times.push_back(elapsed.count());
+         total += elapsed.count();
+         if (result.fitness == 0) {
+            solved++;
+         }
+      }
+
+      sort(times.begin(), times.end());
+      cout << names[e] << "," << puzzles.size() << "," << solved << ","
+         << (double) solved / puzzles.size() << ","
+         << total / puzzles.size() << ","
+         << times[times.size() / 2] << ","
+         << times[(size_t)(0.99 * (times.size() - 1) + 0.5)] << endl;
+   }
+
+   return 0;
+}
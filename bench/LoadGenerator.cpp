@@ -0,0 +1,259 @@
+/*
+* LoadGenerator.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program is a client for the solve daemon (see SolveDaemon.h) that
+* measures its throughput and tail latency. It connects to the daemon's
+* Unix socket, sends jobs made from the puzzles of a corpus (cycling
+* through them) and reads the replies on a second thread. Jobs are sent in
+* one of two ways:
+*    - closed loop (the default): at most --in-flight jobs are waiting for
+*      a reply at any time, like that many clients that each wait for an
+*      answer before asking again
+*    - open loop (--rate R): R jobs per second are sent on a fixed
+*      schedule whether or not replies have come back. A job's latency is
+*      measured from when it was due to be sent, so time spent blocked by
+*      the daemon's backpressure counts against it.
+* When every reply is in, one CSV row is printed:
+*
+*    jobs,in_flight,rate,seconds,jobs_per_sec,solved,timeouts,errors,
+*    p50_ms,p90_ms,p99_ms,max_ms
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/LoadGenerator.cpp -o loadgen
+* Usage (defaults shown), with a daemon started by
+* "./ga 1000 300 --serve /tmp/sudoku.sock":
+*    ./loadgen <socket> [--corpus bench/corpus/hard.txt] [--jobs 200] \
+*       [--in-flight 8] [--rate 0] [--time-limit 0]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "PuzzleCorpus.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/*
+* This helper returns the value at fraction (0-1) of the way through a
+* sorted list, or 0 if the list is empty.
+*/
+static double percentile(const vector<double>& sorted, double fraction) {
+   if (sorted.empty()) {
+      return 0;
+   }
+   return sorted[(size_t) (fraction * (sorted.size() - 1) + 0.5)];
+}
+
+/*
+* This helper writes all of text to fd. Returns false if the connection
+* failed.
+*/
+static bool sendAll(int fd, const string& text) {
+   const char* data = text.data();
+   size_t left = text.size();
+   // Invariant: the first text.size() - left bytes have been sent
+   while (left > 0) {
+      ssize_t sent = write(fd, data, left);
+      if (sent <= 0) {
+         return false;
+      }
+      data += sent;
+      left -= sent;
+   }
+   return true;
+}
+
+int main(int argc, char* argv[]) {
+   if (argc < 2) {
+      cout << "Usage: " << argv[0] << " <socket> [--corpus FILE] [--jobs N]"
+         << " [--in-flight N] [--rate R] [--time-limit MS]" << endl;
+      return -1;
+   }
+   string socketPath = argv[1];
+   string corpusFile = "bench/corpus/hard.txt";
+   int jobs = 200;
+   int inFlight = 8;
+   double rate = 0;
+   double timeLimit = 0;
+   string timeLimitText;          // sent as given, so fractions survive
+   try {
+      for (int i = 2; i < argc; i++) {
+         string flag = argv[i];
+         if (i + 1 >= argc) {
+            throw runtime_error(flag + " needs a value");
+         }
+         if (flag == "--corpus") {
+            corpusFile = argv[++i];
+         } else if (flag == "--jobs") {
+            jobs = stoi(argv[++i]);
+         } else if (flag == "--in-flight") {
+            inFlight = stoi(argv[++i]);
+         } else if (flag == "--rate") {
+            rate = stod(argv[++i]);
+         } else if (flag == "--time-limit") {
+            timeLimitText = argv[++i];
+            timeLimit = stod(timeLimitText);
+         } else {
+            throw runtime_error("Unknown flag " + flag);
+         }
+      }
+      if (jobs < 1 || inFlight < 1 || rate < 0 || timeLimit < 0) {
+         throw runtime_error("Arguments must be positive");
+      }
+   }
+   catch (exception& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   // The puzzles jobs are made from, as 81-character lines
+   vector<string> puzzles;
+   try {
+      PuzzleCorpus corpus(corpusFile);
+      Sudoku sudoku;
+      long long line;
+      char cells[81];
+      while (corpus.next(sudoku, line)) {
+         sudoku.writeCells(cells);
+         puzzles.push_back(string(cells, 81));
+      }
+   }
+   catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+   if (puzzles.empty()) {
+      cout << "ERROR: " << corpusFile << " has no puzzles" << endl;
+      return -1;
+   }
+
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path)
+      - 1);
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0 || connect(fd, (sockaddr*) &address, sizeof(address)) != 0) {
+      cout << "ERROR: Cannot connect to " << socketPath << endl;
+      return -1;
+   }
+
+   // Shared between the sender and the receiver
+   mutex lock;
+   condition_variable replied;
+   vector<Clock::time_point> sentAt(jobs);
+   vector<double> latencies;
+   int waiting = 0;
+   int solved = 0;
+   int timeouts = 0;
+   int errors = 0;
+
+   // The receiver reads reply lines until every job is answered
+   thread receiver([&]() {
+      string pending;
+      char buffer[1 << 16];
+      int received = 0;
+      while (received < jobs) {
+         ssize_t count = read(fd, buffer, sizeof(buffer));
+         if (count <= 0) {
+            break;
+         }
+         Clock::time_point now = Clock::now();
+         pending.append(buffer, count);
+
+         size_t newline;
+         while ((newline = pending.find('\n')) != string::npos) {
+            istringstream reply(pending.substr(0, newline));
+            pending.erase(0, newline + 1);
+            int id = -1;
+            string status;
+            reply >> id >> status;
+
+            lock_guard<mutex> guard(lock);
+            received++;
+            waiting--;
+            if (id >= 0 && id < jobs) {
+               chrono::duration<double, milli> latency = now - sentAt[id];
+               latencies.push_back(latency.count());
+            }
+            if (status == "solved") {
+               solved++;
+            } else if (status == "timeout") {
+               timeouts++;
+            } else if (status != "unsolved") {
+               errors++;
+            }
+            replied.notify_one();
+         }
+      }
+
+      // Unblock the sender if the daemon went away
+      lock_guard<mutex> guard(lock);
+      waiting = -jobs;
+      replied.notify_one();
+   });
+
+   Clock::time_point start = Clock::now();
+   string suffix = timeLimit > 0 ? " " + timeLimitText : "";
+   // Invariant: jobs 0 to i - 1 have been sent
+   for (int i = 0; i < jobs; i++) {
+      Clock::time_point due;
+      if (rate > 0) {
+         // Open loop: send on schedule and measure from the schedule
+         due = start + chrono::duration_cast<Clock::duration>(
+            chrono::duration<double>(i / rate));
+         this_thread::sleep_until(due);
+      }
+
+      {
+         unique_lock<mutex> guard(lock);
+         if (rate == 0) {
+            // Closed loop: wait for a free slot
+            replied.wait(guard, [&]() { return waiting < inFlight; });
+            due = Clock::now();
+         }
+         sentAt[i] = due;
+         waiting++;
+      }
+
+      string line = to_string(i) + " " + puzzles[i % puzzles.size()]
+         + suffix + "\n";
+      if (!sendAll(fd, line)) {
+         cout << "ERROR: The daemon closed the connection" << endl;
+         break;
+      }
+   }
+
+   // No more jobs; the daemon still answers the ones it has
+   shutdown(fd, SHUT_WR);
+   receiver.join();
+   close(fd);
+   chrono::duration<double> elapsed = Clock::now() - start;
+
+   sort(latencies.begin(), latencies.end());
+   double seconds = elapsed.count();
+   cout << "jobs,in_flight,rate,seconds,jobs_per_sec,solved,timeouts,errors,"
+      << "p50_ms,p90_ms,p99_ms,max_ms" << endl;
+   cout << latencies.size() << "," << (rate > 0 ? 0 : inFlight) << ","
+      << rate << "," << seconds << "," << latencies.size() / seconds << ","
+      << solved << "," << timeouts << "," << errors << ","
+      << percentile(latencies, 0.5) << "," << percentile(latencies, 0.9)
+      << "," << percentile(latencies, 0.99) << ","
+      << (latencies.empty() ? 0 : latencies.back()) << endl;
+   return 0;
+}
@@ -0,0 +1,264 @@
+/*
+* MicroBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program measures the hot paths of the genetic algorithm one at a
+* time: scoring a board (SudokuFitness#howFit and #howFitMask), the Sudoku
+* copy constructor, making an offspring (SudokuOffspring#makeOffspring and
+* its Into version), filling a board (SudokuFactory#fillPuzzle and its
+* Into version), SudokuPopulation#cull and a full generation (cull plus
+* newGeneration, with and without arena storage).
+*
+* Every operation is repeated, doubling the count, until it has run for at
+* least the minimum time. The board operations run on every puzzle of each
+* corpus file and the population operations run at several population
+* sizes. The results are written to cout as CSV with one row per
+* measurement, so runs can be saved and compared to catch regressions:
+*
+*    benchmark,corpus,pop_size,ops,ns_per_op,allocs_per_op,ops_per_sec
+*
+* The corpus is the file name without its extension. pop_size is 0 for the
+* board operations.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/MicroBenchmark.cpp -o micro
+* Usage (defaults shown):
+*    ./micro [--pop 100,1000,10000] [--min-time 0.2] \
+*       [bench/corpus/easy.txt bench/corpus/medium.txt bench/corpus/hard.txt]*
+* The scores the fitness kernels return are checked by tests/FitnessTest.cpp,
+* which is built the same way and exits non-zero on a wrong score:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       tests/FitnessTest.cpp -o fitnesstest && ./fitnesstest
+*/
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+#include "PuzzleCorpus.h"
+#include "Random.h"
+#include "Sudoku.h"
+#include "SudokuFactory.h"
+#include "SudokuFitness.h"
+#include "SudokuOffspring.h"
+#include "SudokuPopulation.h"
+
+using namespace std;
+
+/*
+* This struct holds the result of timing one operation.
+*/
+struct Measurement {
+   long long ops = 0;
+   double seconds = 0;
+   long long allocations = 0;
+};
+
+// Results are added into this so the compiler cannot skip the work
+static volatile long long sink = 0;
+
+/*
+* This helper runs op(i) for i = 0, 1, ... doubling the count until the
+* whole batch takes at least minSeconds, and returns the last batch.
+*/
+template <typename Op>
+static Measurement measure(Op& op, double minSeconds) {
+   Measurement result;
+   // Invariant: every batch before this one was too short
+   for (long long ops = 1; ; ops *= 2) {
+      long long allocsBefore = allocationCount();
+      auto start = chrono::steady_clock::now();
+      for (long long i = 0; i < ops; i++) {
+         op(i);
+      }
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+      result.ops = ops;
+      result.seconds = elapsed.count();
+      result.allocations = allocationCount() - allocsBefore;
+      if (result.seconds >= minSeconds || ops >= (1LL << 40)) {
+         return result;
+      }
+   }
+}
+
+/*
+* This helper prints one CSV row.
+*/
+static void report(const string& name, const string& corpus, int popSize,
+   const Measurement& m) {
+   double ops = (double) m.ops;
+   cout << name << "," << corpus << "," << popSize << "," << m.ops << ","
+      << m.seconds * 1e9 / ops << "," << m.allocations / ops << ","
+      << (m.seconds > 0 ? ops / m.seconds : 0) << endl;
+}
+
+/*
+* This helper times one generation step of a population of popSize built
+* from puzzle. If cullOnly is true only cull is timed (newGeneration still
+* runs between culls to refill the population).
+*/
+static Measurement measurePopulation(const Sudoku& puzzle, int popSize,
+   bool arena, bool cullOnly, double minSeconds) {
+   SudokuPopulation pop(puzzle, popSize, 343, arena);
+   Measurement result;
+
+   // Invariant: every batch before this one was too short
+   for (long long ops = 1; ; ops *= 2) {
+      result = Measurement();
+      result.ops = ops;
+
+      for (long long i = 0; i < ops; i++) {
+         long long allocsBefore = allocationCount();
+         auto start = chrono::steady_clock::now();
+         pop.cull(0.9);
+         if (!cullOnly) {
+            pop.newGeneration();
+         }
+         chrono::duration<double> elapsed =
+            chrono::steady_clock::now() - start;
+         result.seconds += elapsed.count();
+         result.allocations += allocationCount() - allocsBefore;
+
+         if (cullOnly) {
+            pop.newGeneration();
+         }
+      }
+
+      if (result.seconds >= minSeconds || ops >= (1LL << 40)) {
+         return result;
+      }
+   }
+}
+
+int main(int argc, char* argv[]) {
+   vector<int> popSizes = { 100, 1000, 10000 };
+   double minSeconds = 0.2;
+   vector<string> files;
+
+   // Parse the flags and corpus files
+   try {
+      for (int i = 1; i < argc; i++) {
+         string arg = argv[i];
+         if (arg == "--pop" && i + 1 < argc) {
+            popSizes.clear();
+            stringstream list(argv[++i]);
+            string size;
+            while (getline(list, size, ',')) {
+               popSizes.push_back(stoi(size));
+            }
+         } else if (arg == "--min-time" && i + 1 < argc) {
+            minSeconds = stod(argv[++i]);
+         } else {
+            files.push_back(arg);
+         }
+      }
+   }
+   catch (exception&) {
+      cout << "ERROR: Invalid arguments provided." << endl;
+      return -1;
+   }
+   if (files.empty()) {
+      files = { "bench/corpus/easy.txt", "bench/corpus/medium.txt",
+         "bench/corpus/hard.txt" };
+   }
+
+   SudokuFitness& fitness = SudokuFitness::getInstance();
+   SudokuOffspring& offspring = SudokuOffspring::getInstance();
+   SudokuFactory& factory = SudokuFactory::getInstance();
+
+   cout << "benchmark,corpus,pop_size,ops,ns_per_op,allocs_per_op,ops_per_sec"
+      << endl;
+
+   for (const string& file : files) {
+      // Corpus name is the file name without directory or extension
+      string corpus = file.substr(file.find_last_of('/') + 1);
+      corpus = corpus.substr(0, corpus.find('.'));
+
+      vector<Sudoku> puzzles;
+      try {
+         PuzzleCorpus reader(file);
+         Sudoku sudoku;
+         long long line;
+         while (reader.next(sudoku, line)) {
+            puzzles.push_back(sudoku);
+         }
+      }
+      catch (runtime_error& err) {
+         cout << "ERROR: " << err.what() << endl;
+         return -1;
+      }
+      if (puzzles.empty()) {
+         cout << "ERROR: " << file << " has no puzzles." << endl;
+         return -1;
+      }
+
+      // Randomly filled boards for the operations that need them
+      Random rng(343);
+      int count = (int) puzzles.size();
+      vector<Sudoku> boards(count);
+      for (int i = 0; i < count; i++) {
+         factory.fillPuzzleInto(puzzles[i], boards[i], rng);
+      }
+      Sudoku scratch;
+
+      auto howFit = [&](long long i) {
+         sink += fitness.howFit(boards[i % count]);
+      };
+      report("howFit", corpus, 0, measure(howFit, minSeconds));
+
+      auto howFitMask = [&](long long i) {
+         sink += fitness.howFitMask(boards[i % count]);
+      };
+      report("howFitMask", corpus, 0, measure(howFitMask, minSeconds));
+
+      auto copy = [&](long long i) {
+         Sudoku board(boards[i % count]);
+         sink += board.getHash();
+      };
+      report("copyConstructor", corpus, 0, measure(copy, minSeconds));
+
+      auto makeOffspring = [&](long long i) {
+         unique_ptr<Sudoku> child((Sudoku*) offspring.makeOffspring(
+            boards[i % count], rng));
+         sink += child->getHash();
+      };
+      report("makeOffspring", corpus, 0, measure(makeOffspring, minSeconds));
+
+      auto makeOffspringInto = [&](long long i) {
+         offspring.makeOffspringInto(boards[i % count], scratch, rng);
+         sink += scratch.getHash();
+      };
+      report("makeOffspringInto", corpus, 0,
+         measure(makeOffspringInto, minSeconds));
+
+      auto fillPuzzle = [&](long long i) {
+         unique_ptr<Sudoku> board((Sudoku*) factory.fillPuzzle(
+            puzzles[i % count], rng));
+         sink += board->getHash();
+      };
+      report("fillPuzzle", corpus, 0, measure(fillPuzzle, minSeconds));
+
+      auto fillPuzzleInto = [&](long long i) {
+         factory.fillPuzzleInto(puzzles[i % count], scratch, rng);
+         sink += scratch.getHash();
+      };
+      report("fillPuzzleInto", corpus, 0, measure(fillPuzzleInto, minSeconds));
+
+      // Population operations start from the first puzzle of the corpus
+      for (int popSize : popSizes) {
+         report("cull", corpus, popSize,
+            measurePopulation(puzzles[0], popSize, false, true, minSeconds));
+         report("generation", corpus, popSize,
+            measurePopulation(puzzles[0], popSize, false, false, minSeconds));
+         report("generationArena", corpus, popSize,
+            measurePopulation(puzzles[0], popSize, true, false, minSeconds));
+      }
+   }
+
+   return 0;
+}
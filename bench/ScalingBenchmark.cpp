@@ -0,0 +1,90 @@
+/*
+* ScalingBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program measures how the genetic algorithm scales from 1 to N
+* threads. For every thread count it builds the same population (same
+* seed, same chunk size), runs a fixed number of generations and reports
+* the time taken and the speedup over one thread. It also checks that the
+* best fitness matches the serial run, since the chunked generation is
+* supposed to be deterministic.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/ScalingBenchmark.cpp -o scaling
+* Usage:
+*    ./scaling <maxThreads> <popSize> <generations> [chunkSize] < puzzle.txt
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "Sudoku.h"
+#include "SudokuPopulation.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 4) {
+      cout << "Usage: " << argv[0]
+         << " <maxThreads> <popSize> <generations> [chunkSize]" << endl;
+      return -1;
+   }
+
+   int maxThreads, popSize, gens, chunkSize = 1024;
+   try {
+      maxThreads = stoi(argv[1]);
+      popSize = stoi(argv[2]);
+      gens = stoi(argv[3]);
+      if (argc > 4) {
+         chunkSize = stoi(argv[4]);
+      }
+   }
+   catch (exception&) {
+      cout << "ERROR: Invalid arguments provided." << endl;
+      return -1;
+   }
+
+   Sudoku sudoku;
+   try {
+      cin >> sudoku;
+   } catch (runtime_error&) {
+      cout << "ERROR: Invalid sudoku input" << endl;
+      return -1;
+   }
+
+   cout << "threads,seconds,generations_per_second,speedup,best_fitness,"
+      << "matches_serial" << endl;
+
+   double serialSeconds = 0;
+   int serialBest = -1;
+
+   for (int threads = 1; threads <= maxThreads; threads++) {
+      // Same seed for every run so they should all end the same way
+      SudokuPopulation pop(sudoku, popSize, 343, true);
+      ThreadPool pool(threads);
+      pop.setThreads(&pool, chunkSize);
+
+      // Time only the generation loop
+      auto start = chrono::steady_clock::now();
+      for (int i = 0; i < gens; i++) {
+         pop.cull(0.9);
+         pop.newGeneration();
+      }
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+      double seconds = elapsed.count();
+
+      if (threads == 1) {
+         serialSeconds = seconds;
+         serialBest = pop.bestFitness();
+      }
+
+      cout << threads << "," << seconds << "," << gens / seconds << ","
+         << serialSeconds / seconds << "," << pop.bestFitness() << ","
+         << (pop.bestFitness() == serialBest ? "yes" : "no") << endl;
+   }
+
+   return 0;
+}
@@ -0,0 +1,112 @@
+/*
+* SelectionBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program compares the selection strategies (truncation, tournament
+* and rank, see Selection) on one puzzle. Each strategy is run once per
+* seed until the puzzle is solved or the generation limit is reached, and
+* one summary row is printed per strategy: how many runs solved the
+* puzzle, the median generations to solve (unsolved runs count as the
+* limit), the mean best fitness and the mean time per generation. Any
+* solver flag (for example --cull 0.5 or --encoding permutation) can be
+* given after the numbers.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/SelectionBenchmark.cpp -o selection
+* Usage:
+*    ./selection <seeds> <popSize> <maxGenerations> [solver flags] < puzzle
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Solver.h"
+#include "Sudoku.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+   // Check for argument length
+   if (argc < 4) {
+      cout << "Usage: " << argv[0]
+         << " <seeds> <popSize> <maxGenerations> [solver flags]" << endl;
+      return -1;
+   }
+
+   SolverOptions options;
+   int seeds;
+   try {
+      seeds = stoi(argv[1]);
+      options.popSize = stoi(argv[2]);
+      options.maxGens = stoi(argv[3]);
+
+      // Any other solver settings
+      for (int i = 4; i < argc; i++) {
+         if (!parseSolverFlag(argc, argv, i, options)) {
+            throw runtime_error(string("Unknown flag ") + argv[i]);
+         }
+      }
+   }
+   catch (exception& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+   if (seeds < 1) {
+      cout << "ERROR: Need at least one seed." << endl;
+      return -1;
+   }
+
+   Sudoku sudoku;
+   try {
+      cin >> sudoku;
+   } catch (runtime_error&) {
+      cout << "ERROR: Invalid sudoku input" << endl;
+      return -1;
+   }
+
+   const SelectionKind kinds[3] = { TRUNCATION_SELECTION,
+      TOURNAMENT_SELECTION, RANK_SELECTION };
+   const char* names[3] = { "truncation", "tournament", "rank" };
+
+   cout << "selection,runs,solved,median_generations,mean_fitness,"
+      << "ms_per_generation" << endl;
+
+   for (int k = 0; k < 3; k++) {
+      options.selection = kinds[k];
+      vector<int> generations;
+      long long totalGenerations = 0;
+      int solved = 0;
+      double fitness = 0;
+      double milliseconds = 0;
+
+      // Every strategy gets the same seeds
+      for (int seed = 1; seed <= seeds; seed++) {
+         options.seed = seed;
+
+         auto start = chrono::steady_clock::now();
+         SolveResult result = solve(sudoku, options);
+         chrono::duration<double, milli> elapsed =
+            chrono::steady_clock::now() - start;
+
+         generations.push_back(result.generations);
+         totalGenerations += result.generations;
+         fitness += result.fitness;
+         milliseconds += elapsed.count();
+         if (result.fitness == 0) {
+            solved++;
+         }
+      }
+
+      sort(generations.begin(), generations.end());
+      cout << names[k] << "," << seeds << "," << solved << ","
+         << generations[generations.size() / 2] << ","
+         << fitness / seeds << ","
+         << (totalGenerations > 0 ? milliseconds / totalGenerations : 0)
+         << endl;
+   }
+
+   return 0;
+}
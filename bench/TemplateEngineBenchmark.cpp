@@ -0,0 +1,123 @@
+/*
+* TemplateEngineBenchmark.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program measures what is gained by running the generation loop in
+* GeneticEngine, where every fill, mutation and score is a direct call,
+* instead of SudokuPopulation, which goes through the PuzzleFactory,
+* Fitness and Selection interfaces. Both run one thread, truncation
+* selection and arena storage (SudokuPopulation with arena = true) on the
+* same puzzle. Each encoding is timed for the same number of generations,
+* and one CSV row is printed per engine:
+*
+*    engine,encoding,pop_size,generations,ms_per_generation,speedup
+*
+* speedup is the virtual population's time divided by the row's time.
+*
+* Build from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       bench/TemplateEngineBenchmark.cpp -o template
+* Usage (defaults shown):
+*    ./template [popSize 1000] [generations 200] [corpus bench/corpus/hard.txt]
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "GeneticEngine.h"
+#include "PermutationFactory.h"
+#include "PermutationFitness.h"
+#include "PermutationOffspring.h"
+#include "PuzzleCorpus.h"
+#include "Sudoku.h"
+#include "SudokuFactory.h"
+#include "SudokuFitness.h"
+#include "SudokuOffspring.h"
+#include "SudokuPopulation.h"
+#include "TruncationSelection.h"
+
+using namespace std;
+
+/*
+* This helper returns the milliseconds per generation of pop over the
+* given number of generations (cull 90% and newGeneration).
+*/
+template <typename Pop>
+static double timeGenerations(Pop& pop, int generations) {
+   auto start = chrono::steady_clock::now();
+   for (int i = 0; i < generations; i++) {
+      pop.cull(0.9);
+      pop.newGeneration();
+   }
+   chrono::duration<double, milli> elapsed =
+      chrono::steady_clock::now() - start;
+   return elapsed.count() / generations;
+}
+
+/*
+* This helper times both engines with one encoding and prints their rows.
+*/
+template <typename FactoryT, typename FitnessT, typename OffspringT>
+static void compare(const Sudoku& puzzle, Encoding encoding,
+   const string& name, int popSize, int generations) {
+   SudokuPopulation virtualPop(puzzle, popSize, 343, true, encoding);
+   double virtualMs = timeGenerations(virtualPop, generations);
+
+   GeneticEngine<Sudoku, FactoryT, FitnessT, OffspringT, TruncationSelection>
+      engine(puzzle, popSize, 343);
+   double engineMs = timeGenerations(engine, generations);
+
+   cout << "virtual," << name << "," << popSize << "," << generations << ","
+      << virtualMs << ",1" << endl;
+   cout << "template," << name << "," << popSize << "," << generations << ","
+      << engineMs << "," << virtualMs / engineMs << endl;
+}
+
+int main(int argc, char* argv[]) {
+   int popSize = 1000;
+   int generations = 200;
+   string file = "bench/corpus/hard.txt";
+   try {
+      if (argc > 1) {
+         popSize = stoi(argv[1]);
+      }
+      if (argc > 2) {
+         generations = stoi(argv[2]);
+      }
+      if (argc > 3) {
+         file = argv[3];
+      }
+   }
+   catch (exception&) {
+      cout << "Usage: " << argv[0] << " [popSize] [generations] [corpus]"
+         << endl;
+      return -1;
+   }
+   if (popSize < 1 || generations < 1) {
+      cout << "ERROR: Arguments must be positive." << endl;
+      return -1;
+   }
+
+   // The first puzzle of the corpus
+   Sudoku puzzle;
+   try {
+      PuzzleCorpus corpus(file);
+      long long line;
+      if (!corpus.next(puzzle, line)) {
+         throw runtime_error(file + " has no puzzles");
+      }
+   }
+   catch (runtime_error& err) {
+      cout << "ERROR: " << err.what() << endl;
+      return -1;
+   }
+
+   cout << "engine,encoding,pop_size,generations,ms_per_generation,speedup"
+      << endl;
+   compare<SudokuFactory, SudokuFitness, SudokuOffspring>(puzzle,
+      CELL_ENCODING, "cells", popSize, generations);
+   compare<PermutationFactory, PermutationFitness, PermutationOffspring>(
+      puzzle, PERMUTATION_ENCODING, "permutation", popSize, generations);
+
+   return 0;
+}
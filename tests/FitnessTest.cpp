@@ -0,0 +1,77 @@
+/*
+* FitnessTest.cpp
+* Timothy Kozlov, Eric Pham
+*
+* This program checks SudokuFitness#howFitMask and #howFitCompact against
+* the original howFit on the sample boards listed at the top of
+* SudokuFitness.cpp. For every board all three must give the expected
+* number of issues. It prints one line per board and returns non-zero if
+* any of them is wrong. Run it after changing any fitness kernel; the
+* benchmarks (see bench/MicroBenchmark.cpp) only measure their speed.
+*
+* Build and run from the repository root:
+*    g++ -std=c++17 -O2 -pthread -I. $(ls *.cpp | grep -v GeneticAlgorithm) \
+*       tests/FitnessTest.cpp -o fitnesstest && ./fitnesstest
+*/
+
+#include <iostream>
+#include <string>
+#include "CompactSudoku.h"
+#include "Sudoku.h"
+#include "SudokuFitness.h"
+
+using namespace std;
+
+/*
+* This struct is one sample board and its expected fitness.
+*/
+struct Sample {
+   const char* cells;
+   int expected;
+};
+
+// The samples from SudokuFitness.cpp
+const Sample SAMPLES[] = {
+   { "528974613916238475743165982391827546274653198685491327867519234"
+      "459382761132746859", 0 },
+   { "328974613916238475743165982391827546274653198685491327867519234"
+      "459382761132746859", 3 },
+   { "328974613916238475743165982391827546274653198685491327867519234"
+      "459382761132746858", 6 },
+   { "111111111111111111111111111111111111111111111111111111111111111"
+      "111111111111111111", 216 },
+   { "000000000000000000000000000000000000000000000000000000000000000"
+      "000000000000000000", 216 },
+   { "600002090000010802340000100000041600060000020009680000006000054"
+      "703090000020500006", 138 },
+};
+
+int main() {
+   SudokuFitness& fitness = SudokuFitness::getInstance();
+   int failures = 0;
+
+   for (const Sample& sample : SAMPLES) {
+      unsigned char digits[81];
+      for (int cell = 0; cell < 81; cell++) {
+         digits[cell] = (unsigned char) (sample.cells[cell] - '0');
+      }
+      Sudoku board;
+      board.loadCells(digits);
+
+      int mask = fitness.howFitMask(board);
+      int compact = fitness.howFitCompact(CompactSudoku(board));
+      int full = fitness.howFit(board);
+      bool passed = mask == sample.expected && compact == sample.expected
+         && full == sample.expected;
+      if (!passed) {
+         failures++;
+      }
+
+      cout << (passed ? "PASS " : "FAIL ") << string(sample.cells, 9)
+         << "... expected " << sample.expected << ", howFitMask " << mask
+         << ", howFitCompact " << compact << ", howFit " << full << endl;
+   }
+
+   cout << failures << " of " << size(SAMPLES) << " samples failed" << endl;
+   return failures == 0 ? 0 : 1;
+}